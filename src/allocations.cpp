@@ -0,0 +1,85 @@
+#include "allocations.h"
+#include <new>
+
+static atomic<Uint64> total_allocations{0};
+static atomic<Uint64> total_bytes{0};
+static atomic<Sint64> total_live_bytes{0};
+static thread_local Uint64 thread_allocations = 0;
+static thread_local Uint64 thread_bytes = 0;
+
+#ifdef SPACE_INVERSION_TRACK_ALLOCATIONS
+// every block starts with a header that keeps its size, as big as the alignment malloc gives so what comes after
+// it is aligned the same way.
+static const size_t HEADER = alignof(max_align_t);
+
+static void Count(size_t size){
+    total_allocations.fetch_add(1, memory_order_relaxed);
+    total_bytes.fetch_add(size, memory_order_relaxed);
+    total_live_bytes.fetch_add(size, memory_order_relaxed);
+    thread_allocations++;
+    thread_bytes += size;
+}
+
+void * operator new(size_t size){
+    char * block = static_cast<char *>(malloc(size + HEADER));
+    if (!block){
+        throw bad_alloc();
+    }
+    *reinterpret_cast<size_t *>(block) = size;
+    Count(size);
+    return block + HEADER;
+}
+
+void operator delete(void * pointer) noexcept {
+    if (!pointer){return;}
+    char * block = static_cast<char *>(pointer) - HEADER;
+    total_live_bytes.fetch_sub(*reinterpret_cast<size_t *>(block), memory_order_relaxed);
+    free(block);
+}
+
+// over-aligned types get as much room in front as they need to be aligned, the size and the block malloc gave
+// are kept right before the pointer handed out.
+void * operator new(size_t size, align_val_t align){
+    size_t alignment = max(size_t(align), HEADER);
+    char * block = static_cast<char *>(malloc(size + alignment + HEADER));
+    if (!block){
+        throw bad_alloc();
+    }
+    uintptr_t start = (reinterpret_cast<uintptr_t>(block) + HEADER + alignment - 1) & ~uintptr_t(alignment - 1);
+    void ** header = reinterpret_cast<void **>(start);
+    header[-1] = block;
+    header[-2] = reinterpret_cast<void *>(size);
+    Count(size);
+    return header;
+}
+
+void operator delete(void * pointer, align_val_t align) noexcept {
+    if (!pointer){return;}
+    void ** header = static_cast<void **>(pointer);
+    total_live_bytes.fetch_sub(reinterpret_cast<size_t>(header[-2]), memory_order_relaxed);
+    free(header[-1]);
+}
+#endif
+
+bool Allocations::Tracking(){
+    #ifdef SPACE_INVERSION_TRACK_ALLOCATIONS
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+AllocationStats Allocations::Totals(){
+    AllocationStats totals;
+    totals.allocations = total_allocations.load(memory_order_relaxed);
+    totals.bytes = total_bytes.load(memory_order_relaxed);
+    totals.live_bytes = total_live_bytes.load(memory_order_relaxed);
+    return totals;
+}
+
+AllocationStats Allocations::Thread(){
+    AllocationStats stats;
+    stats.allocations = thread_allocations;
+    stats.bytes = thread_bytes;
+    return stats;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "headers.h"
+
+/*
+    Counts what goes through the global operator new and delete: how many allocations, how many bytes, and how much
+    of the heap is still in use. The profiler shows the counts per frame and per zone, and the headless mode can check
+    that a level stops allocating once it is running.
+    The hook is only compiled in when SPACE_INVERSION_TRACK_ALLOCATIONS is defined, since every allocation pays for
+    a few counters and a header with its size. Without it the counts stay at zero and Tracking is false.
+*/
+struct AllocationStats {
+    // since the program started.
+    Uint64 allocations = 0;
+    Uint64 bytes = 0;
+    // bytes allocated and not deleted yet.
+    Sint64 live_bytes = 0;
+};
+
+class Allocations {
+    public:
+        static bool Tracking();
+        // what all the threads allocated together, this can be read from any thread.
+        static AllocationStats Totals();
+        // what the calling thread allocated, without live_bytes since memory can be deleted on another thread.
+        static AllocationStats Thread();
+};
@@ -0,0 +1,93 @@
+#include "arena.h"
+
+// what all the arenas hold together.
+static atomic<size_t> total_used{0};
+static atomic<size_t> total_capacity{0};
+static atomic<int> total_blocks{0};
+
+Arena::Arena(size_t block_size){
+    this->block_size = block_size;
+}
+
+Arena::Block * Arena::AddBlock(size_t size){
+    // the block keeps its bookkeeping at its start, the memory handed out comes after it.
+    Block * block = static_cast<Block *>(::operator new(sizeof(Block) + size));
+    block->next = blocks;
+    block->size = size;
+    block->used = 0;
+    blocks = block;
+
+    stats.capacity += size;
+    stats.blocks++;
+    total_capacity += size;
+    total_blocks++;
+    return block;
+}
+
+void * Arena::Allocate(size_t size, size_t align){
+    Block * block = blocks;
+    uintptr_t start = 0;
+    if (block){
+        uintptr_t base = reinterpret_cast<uintptr_t>(block + 1);
+        start = (base + block->used + align - 1) & ~uintptr_t(align - 1);
+        if (start + size > base + block->size){
+            block = nullptr;
+        }
+    }
+
+    if (!block){
+        // something bigger than a block gets a block of its own.
+        block = AddBlock(max(block_size, size + align));
+        uintptr_t base = reinterpret_cast<uintptr_t>(block + 1);
+        start = (base + align - 1) & ~uintptr_t(align - 1);
+    }
+
+    size_t used = start + size - reinterpret_cast<uintptr_t>(block + 1);
+    size_t added = used - block->used;
+    block->used = used;
+
+    stats.used += added;
+    stats.peak = max(stats.peak, stats.used);
+    stats.allocations++;
+    total_used += added;
+    return reinterpret_cast<void *>(start);
+}
+
+void Arena::Release(){
+    // the newest objects go first, they can be made of the ones before them.
+    while (finalizers){
+        Finalizer * finalizer = finalizers;
+        finalizers = finalizer->next;
+        finalizer->destroy(finalizer->object);
+    }
+
+    while (blocks){
+        Block * block = blocks;
+        blocks = block->next;
+        ::operator delete(block);
+    }
+
+    total_used -= stats.used;
+    total_capacity -= stats.capacity;
+    total_blocks -= stats.blocks;
+
+    size_t peak = stats.peak;
+    stats = ArenaStats();
+    stats.peak = peak;
+}
+
+ArenaStats Arena::Stats(){
+    return stats;
+}
+
+ArenaStats Arena::Totals(){
+    ArenaStats totals;
+    totals.used = total_used;
+    totals.capacity = total_capacity;
+    totals.blocks = total_blocks;
+    return totals;
+}
+
+Arena::~Arena(){
+    Release();
+}
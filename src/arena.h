@@ -0,0 +1,106 @@
+#pragma once
+#include "headers.h"
+
+/*
+    A monotonic arena: memory is handed out of big blocks by moving an offset forward, and is never given back
+    one object at a time. Everything in it goes at once with Release (or when the arena is destroyed), which runs
+    the destructors of the objects made with New, newest first, and frees the blocks.
+    A level puts everything it owns in its own arena, so leaving a level is a handful of frees instead of one per
+    object, and the heap doesn't fill up with holes of all sizes.
+*/
+struct ArenaStats {
+    // bytes handed out, and bytes in blocks.
+    size_t used = 0;
+    size_t capacity = 0;
+    size_t peak = 0;
+    int blocks = 0;
+    int allocations = 0;
+    // objects that have a destructor to run on release.
+    int objects = 0;
+};
+
+class Arena {
+    private:
+        struct Block {
+            Block * next;
+            size_t size;
+            size_t used;
+        };
+        struct Finalizer {
+            void (*destroy)(void *);
+            void * object;
+            Finalizer * next;
+        };
+
+        size_t block_size;
+        Block * blocks = nullptr;
+        Finalizer * finalizers = nullptr;
+        ArenaStats stats;
+
+        Block * AddBlock(size_t size);
+
+    public:
+        Arena(size_t block_size = 64 * 1024);
+        ~Arena();
+
+        void * Allocate(size_t size, size_t align = alignof(max_align_t));
+        void Release();
+        ArenaStats Stats();
+        // the usage of all arenas together, this can be read from any thread.
+        static ArenaStats Totals();
+
+        template <class T, class... Args>
+        T * New(Args &&... args){
+            T * object = new (Allocate(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+            if (!is_trivially_destructible<T>::value){
+                Finalizer * finalizer = new (Allocate(sizeof(Finalizer), alignof(Finalizer))) Finalizer();
+                finalizer->destroy = [](void * o){ static_cast<T *>(o)->~T(); };
+                finalizer->object = object;
+                finalizer->next = finalizers;
+                finalizers = finalizer;
+                stats.objects++;
+            }
+            return object;
+        }
+};
+
+/*
+    Lets a vector keep its elements in an arena: ArenaVector<int> numbers(&arena).
+    Without an arena it uses the heap like any other vector, so the same type works inside and outside a level.
+    The arena goes along when the vector is moved, copied or swapped.
+*/
+template <class T>
+struct ArenaAllocator {
+    typedef T value_type;
+    typedef true_type propagate_on_container_copy_assignment;
+    typedef true_type propagate_on_container_move_assignment;
+    typedef true_type propagate_on_container_swap;
+
+    Arena * arena = nullptr;
+
+    ArenaAllocator(Arena * arena = nullptr) : arena(arena) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T * allocate(size_t n){
+        if (!arena){
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T *>(arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T * pointer, size_t n){
+        // memory of an arena is only given back when the whole arena is.
+        if (!arena){
+            ::operator delete(pointer);
+        }
+    }
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b){ return a.arena == b.arena; }
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b){ return a.arena != b.arena; }
+
+template <class T>
+using ArenaVector = vector<T, ArenaAllocator<T>>;
@@ -1,9 +1,10 @@
 #include "bullets.h"
 
-Bullet::Bullet(SDL_Renderer * r, int x, int y, int w, int h, SDL_Color c){
-    renderer = r;
+Bullet::Bullet(int x, int y, int w, int h, SDL_Color c){
     x_pos = x;
     y_pos = y;
+    last_x = x;
+    last_y = y;
     width = w;
     height = h;
     color = c;
@@ -11,12 +12,11 @@ Bullet::Bullet(SDL_Renderer * r, int x, int y, int w, int h, SDL_Color c){
     bullet.x = x_pos; bullet.y = y_pos; bullet.h = height; bullet.w = width;
 }
 
-void Bullet::Render(){
+void Bullet::Render(RenderSnapshot * snapshot){
     bullet.x = (x_pos - int(bullet.w / 2)) ;
     bullet.y = (y_pos - int(bullet.h / 2));  
 
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-    SDL_RenderFillRect(renderer, &bullet);
+    snapshot->AddRect(color, bullet.w, bullet.h, x_pos, y_pos, last_x, last_y);
 }
 
 bool Bullet::IsTouchingRect(SDL_Rect* rect){
@@ -1,17 +1,18 @@
 #pragma once
 #include "headers.h"
+#include "snapshot.h"
 
 class Bullet {
 private:
-SDL_Renderer * renderer;
     int width, height;
     SDL_Color color;
 public:
     float x_pos, y_pos;
+    float last_x, last_y;
     SDL_Rect bullet;
     bool hit = false;
-    Bullet(SDL_Renderer * r, int x, int y, int w, int h, SDL_Color c);
-    void Render();
+    Bullet(int x, int y, int w, int h, SDL_Color c);
+    void Render(RenderSnapshot * snapshot);
     bool IsTouchingRect(SDL_Rect *);
     ~Bullet();
 };
\ No newline at end of file
@@ -7,7 +7,6 @@ Button::Button(int x, int y, int w, int h, SpriteCache * cache){
     area.y = y;
     area.w = w;
     area.h = h;
-    renderer = cache->renderer;
 }
 
 Button::~Button(){}
@@ -22,24 +21,19 @@ bool Button::MouseClicking(MouseManager * mouse){
 
 void Button::Process(Clock * clock){}
 
-void Button::Render(){}
+void Button::Render(RenderSnapshot * snapshot){}
 
 
 SpriteButton::SpriteButton(SpriteCache * cache, string filepath, int x, int y, int w, int h, SDL_Rect src, int frames, int offset, double update_time)
 : Button(x, y, w, h, cache){
-    sprites["DEFAULT"] = new Sprite(cache, src, area, filepath);
-    sprites["TOUCHED"] = new AnimatedSprite(cache, src, area, filepath, offset, frames, update_time);
-    state = "DEFAULT";
+    sprites[BUTTON_DEFAULT] = new Sprite(cache, src, area, filepath);
+    sprites[BUTTON_TOUCHED] = new AnimatedSprite(cache, src, area, filepath, offset, frames, update_time);
+    state = BUTTON_DEFAULT;
     is_touched = false;
 }
 
 void SpriteButton::Process(Clock * clock){
-    if (is_touched) {
-        state = "TOUCHED";
-    }
-    else {
-        state = "DEFAULT";
-    }
+    state = button_transitions[state][is_touched ? BUTTON_ENTER : BUTTON_LEAVE];
     sprites[state]->SetPos(x_pos, y_pos);
     area = sprites[state]->d_rect;
     sprites[state]->Animate(clock);
@@ -50,6 +44,12 @@ bool SpriteButton::MouseTouching(MouseManager * mouse){
     return is_touched;
 }
 
-void SpriteButton::Render(){
-    sprites[state]->Render();
+void SpriteButton::Render(RenderSnapshot * snapshot){
+    sprites[state]->Render(snapshot);
+}
+
+SpriteButton::~SpriteButton(){
+    for (auto sprite: sprites){
+        delete sprite;
+    }
 }
\ No newline at end of file
@@ -5,8 +5,7 @@
 class Button {
     protected:
         SDL_Rect area;
-        SDL_Renderer * renderer;
-        string state;
+        ButtonState state = BUTTON_DEFAULT;
         
     public:
         bool highlight = false;
@@ -19,16 +18,17 @@ class Button {
         virtual bool MouseTouching(MouseManager * mouse);
         virtual bool MouseClicking(MouseManager * mouse);
         virtual void Process(Clock * clock);
-        virtual void Render();
+        virtual void Render(RenderSnapshot * snapshot);
 };
 
 class SpriteButton : public Button{
     private: 
-        map<string, Sprite *> sprites;
+        Sprite * sprites[BUTTON_STATE_COUNT] = {};
         bool is_touched;
     public:
         SpriteButton(SpriteCache * cache, string filepath, int x, int y, int w, int h, SDL_Rect src, int frames = 1, int offset = 0, double update_time = 0 );
         void Process(Clock * clock);
         bool MouseTouching(MouseManager * mouse);
-        void Render();
+        void Render(RenderSnapshot * snapshot);
+        ~SpriteButton();
 };
\ No newline at end of file
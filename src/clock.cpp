@@ -3,17 +3,84 @@
 Clock::Clock(){
     delta_time = 0;
     delta_time_s = 0;
+    delta_time_ns = 0;
+    frequency = SDL_GetPerformanceFrequency();
+    if (!frequency){
+        frequency = 1000;
+    }
     last_time = 0;
-    current_time = SDL_GetTicks();
+    current_time = SDL_GetPerformanceCounter();
 }
 
 void Clock::Tick(){
     last_time = current_time;
-    current_time = SDL_GetTicks();
+    current_time = SDL_GetPerformanceCounter();
     // delta time is the time between the first and last frame, used to have accurate timing.
-    delta_time = (current_time - last_time);
+    // the performance counter is converted in two parts so that the multiplication can't overflow.
+    Uint64 ticks = current_time - last_time;
+    delta_time_ns = (ticks / frequency) * 1000000000 + ((ticks % frequency) * 1000000000) / frequency;
+    delta_time = delta_time_ns * .000001;
     // converts delta time, which is in milleseconds, into how it is in seconds. so if delta was 1ms, here it'd be .001 second.
     delta_time_s = (delta_time * .001); 
+
+    frame_times[frame_index] = delta_time_ns;
+    frame_index = (frame_index + 1) % FRAME_HISTORY;
+    if (frame_count < FRAME_HISTORY){
+        frame_count++;
+    }
+}
+
+void Clock::SetDelta(double seconds){
+    // used by the fixed timestep, the delta is set directly instead of being measured.
+    delta_time_s = seconds;
+    delta_time = seconds * 1000;
+    delta_time_ns = Uint64(seconds * 1000000000);
+}
+
+FrameStats Clock::GetFrameStats(){
+    FrameStats stats;
+    if (!frame_count){
+        return stats;
+    }
+
+    sorted_times.assign(frame_times, frame_times + frame_count);
+    sort(sorted_times.begin(), sorted_times.end());
+
+    Uint64 total = 0;
+    for (auto time: sorted_times){
+        total += time;
+    }
+
+    // percentiles use the nearest rank of the sorted frame times.
+    auto percentile = [this](double p){
+        int rank = int(ceil(p * sorted_times.size())) - 1;
+        return sorted_times[max(rank, 0)] * .000001;
+    };
+
+    stats.frames = frame_count;
+    stats.min = sorted_times.front() * .000001;
+    stats.max = sorted_times.back() * .000001;
+    stats.avg = (double(total) / frame_count) * .000001;
+    stats.p50 = percentile(.50);
+    stats.p95 = percentile(.95);
+    stats.p99 = percentile(.99);
+    return stats;
+}
+
+int Clock::CountFramesOver(double ms){
+    Uint64 limit = Uint64(ms * 1000000);
+    int count = 0;
+    for (int i = 0; i < frame_count; i++){
+        if (frame_times[i] > limit){
+            count++;
+        }
+    }
+    return count;
+}
+
+void Clock::ResetFrameStats(){
+    frame_index = 0;
+    frame_count = 0;
 }
 
 Clock::~Clock(){}
\ No newline at end of file
@@ -1,15 +1,40 @@
 #pragma once
 #include "headers.h"
 
+// Frame pacing statistics over the frames kept in the clock's history, all values are in milliseconds.
+struct FrameStats {
+    double min = 0.0;
+    double avg = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+    int frames = 0;
+};
+
 class Clock{
     public:
+        static const int FRAME_HISTORY = 4096;
+
         double delta_time_s;
         double delta_time;
+        Uint64 delta_time_ns;
         Clock();
         void Tick();
+        void SetDelta(double seconds);
+        FrameStats GetFrameStats();
+        int CountFramesOver(double ms);
+        void ResetFrameStats();
         ~Clock();
        
     private:
-        uint32_t last_time;
-        uint32_t current_time;
+        Uint64 frequency;
+        Uint64 last_time;
+        Uint64 current_time;
+
+        // ring buffer of the last frame times in nanoseconds.
+        Uint64 frame_times[FRAME_HISTORY];
+        int frame_index = 0;
+        int frame_count = 0;
+        std::vector<Uint64> sorted_times;
 };
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "collision.h"
+#include <climits>
+
+CollisionGrid::CollisionGrid(Arena * arena, int cell_size){
+    this->cell_size = cell_size;
+    for (auto &layer: layers){
+        layer = Layer(arena);
+    }
+}
+
+// the moments of the tick at which the moving span [position, position + size) overlaps [low, high). Overlapping
+// has to be more than touching, like SDL_HasIntersection.
+static bool SweepAxis(double position, double size, double delta, double low, double high, double * enter, double * exit){
+    if (delta == 0){
+        return position < high && position + size > low;
+    }
+    double t0 = (low - size - position) / delta;
+    double t1 = (high - position) / delta;
+    if (t0 > t1){
+        swap(t0, t1);
+    }
+    *enter = max(*enter, t0);
+    *exit = min(*exit, t1);
+    return true;
+}
+
+bool SweepRect(const SDL_Rect &start, int dx, int dy, const SDL_Rect &target, double * time){
+    if (start.w <= 0 || start.h <= 0 || target.w <= 0 || target.h <= 0){
+        return false;
+    }
+    double enter = -INFINITY, exit = INFINITY;
+    if (!SweepAxis(start.x, start.w, dx, target.x, target.x + target.w, &enter, &exit) ||
+        !SweepAxis(start.y, start.h, dy, target.y, target.y + target.h, &enter, &exit)){
+        return false;
+    }
+    // the moments both axes overlap have to fall in the tick.
+    if (enter >= exit || enter >= 1 || exit <= 0){
+        return false;
+    }
+    *time = max(enter, 0.0);
+    return true;
+}
+
+CollisionEvents::CollisionEvents(Arena * arena) : events(arena) {}
+
+void CollisionEvents::Emit(CollisionEventKind kind, int subject, int part){
+    if (!events.empty() && events.back().kind == kind && events.back().subject == subject && events.back().part == part){
+        return;
+    }
+    events.push_back({Uint8(kind), subject, part});
+    counts[kind]++;
+}
+
+int CollisionEvents::Count(CollisionEventKind kind){
+    return counts[kind];
+}
+
+void CollisionEvents::Clear(){
+    events.clear();
+    for (auto &count: counts){
+        count = 0;
+    }
+}
+
+void CollisionGrid::Begin(int width, int height){
+    if (width != this->width || height != this->height){
+        this->width = width;
+        this->height = height;
+        columns = max(1, (width + cell_size - 1) / cell_size);
+        rows = max(1, (height + cell_size - 1) / cell_size);
+    }
+    for (auto &layer: layers){
+        layer.entries.clear();
+        layer.built = false;
+    }
+}
+
+void CollisionGrid::Add(CollisionLayer layer, int index, const SDL_Rect &rect){
+    // an empty rect can't intersect anything.
+    if (rect.w <= 0 || rect.h <= 0){
+        return;
+    }
+    layers[layer].entries.push_back({rect, index});
+    layers[layer].built = false;
+}
+
+void CollisionGrid::Cells(const SDL_Rect &rect, int * x0, int * y0, int * x1, int * y1){
+    // floor division, so a rect just left of or above the area doesn't end up in the first cell twice over.
+    auto cell = [&](int position, int count){
+        int c = position >= 0 ? position / cell_size : -((-position + cell_size - 1) / cell_size);
+        return min(max(c, 0), count - 1);
+    };
+    *x0 = cell(rect.x, columns);
+    *y0 = cell(rect.y, rows);
+    *x1 = cell(rect.x + rect.w - 1, columns);
+    *y1 = cell(rect.y + rect.h - 1, rows);
+}
+
+void CollisionGrid::Build(Layer &layer){
+    // count the entries of every cell, turn the counts into where every cell starts, then put the entries in.
+    int cell_count = columns * rows;
+    layer.starts.assign(cell_count + 1, 0);
+    int x0, y0, x1, y1;
+    for (auto &entry: layer.entries){
+        Cells(entry.rect, &x0, &y0, &x1, &y1);
+        for (int y = y0; y <= y1; y++){
+            for (int x = x0; x <= x1; x++){
+                layer.starts[y * columns + x + 1]++;
+            }
+        }
+    }
+    for (int c = 0; c < cell_count; c++){
+        layer.starts[c + 1] += layer.starts[c];
+    }
+
+    layer.items.resize(layer.starts[cell_count]);
+    layer.rects.Resize(layer.starts[cell_count]);
+    // the starts are moved along while filling and put back after.
+    for (int e = 0; e < int(layer.entries.size()); e++){
+        Cells(layer.entries[e].rect, &x0, &y0, &x1, &y1);
+        for (int y = y0; y <= y1; y++){
+            for (int x = x0; x <= x1; x++){
+                int item = layer.starts[y * columns + x]++;
+                layer.items[item] = e;
+                layer.rects.Set(item, layer.entries[e].rect);
+            }
+        }
+    }
+    for (int c = cell_count; c > 0; c--){
+        layer.starts[c] = layer.starts[c - 1];
+    }
+    layer.starts[0] = 0;
+
+    layer.bounds = {};
+    if (!layer.entries.empty()){
+        int left = INT_MAX, top = INT_MAX, right = INT_MIN, bottom = INT_MIN;
+        for (auto &entry: layer.entries){
+            left = min(left, entry.rect.x);
+            top = min(top, entry.rect.y);
+            right = max(right, entry.rect.x + entry.rect.w);
+            bottom = max(bottom, entry.rect.y + entry.rect.h);
+        }
+        layer.bounds = {left, top, right - left, bottom - top};
+    }
+
+    layer.marks.assign(layer.entries.size(), 0);
+    layer.query = 0;
+    layer.built = true;
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include "headers.h"
+#include "arena.h"
+#include "overlap.h"
+
+// What can be put into a CollisionGrid, every layer is kept apart so a query only walks the layer it asks for.
+enum CollisionLayer {
+    LAYER_PLAYER,
+    LAYER_PLAYER_BULLET,
+    LAYER_ENEMY_BULLET,
+    COLLISION_LAYER_COUNT
+};
+
+// a projectile that hits a target, and when in the tick it does, from 0 (the start) to 1 (the end).
+struct CollisionHit {
+    int target;
+    int projectile;
+    double time;
+    // the part of a compound hitbox it hits, or -1 for the whole target.
+    int part;
+};
+
+/*
+    Swept test of a rect that moves by (dx, dy) over the tick against a rect that stands still. It is true when the two
+    overlap at any moment of the tick, and time is the first moment they do. A rect that ends the tick overlapping
+    always hits, so this finds everything the test at the end of the tick finds, and what flew through in between.
+*/
+bool SweepRect(const SDL_Rect &start, int dx, int dy, const SDL_Rect &target, double * time);
+
+// What a collision set off, the level applies all of them together at the end of the tick.
+enum CollisionEventKind {
+    // a player bullet hit an enemy that wasn't hit yet, or shot a part off one.
+    EVENT_ENEMY_HIT,
+    // an enemy was destroyed, by a bullet or by running into the player.
+    EVENT_ENEMY_KILLED,
+    EVENT_PLAYER_HURT,
+    // an enemy bullet hit the player, which turns the screen over.
+    EVENT_INVERSION,
+    COLLISION_EVENT_KIND_COUNT
+};
+
+struct CollisionEvent {
+    Uint8 kind;
+    // the id of the enemy, the enemy bullet of an inversion, or -1 when there is nothing to point at.
+    int subject;
+    // the part of the enemy that was hit, or -1.
+    int part;
+};
+
+/*
+    The events of one tick, so the collision tests only record what happened and the sounds, the rumble, the score
+    and the flip of the screen are applied once for the whole tick. An event that is the same as the one before it is
+    dropped, so an enemy (or a part of it) hit by several bullets at once is hit once. The count of every kind is kept
+    as the events come in, for the consumers that only need to know how many there were.
+*/
+class CollisionEvents {
+    private:
+        int counts[COLLISION_EVENT_KIND_COUNT] = {};
+
+    public:
+        ArenaVector<CollisionEvent> events;
+
+        CollisionEvents(Arena * arena);
+        void Emit(CollisionEventKind kind, int subject = -1, int part = -1);
+        int Count(CollisionEventKind kind);
+        void Clear();
+};
+
+struct CollisionEntry {
+    SDL_Rect rect;
+    // what the rect belongs to, as an index the owner understands.
+    int index;
+};
+
+/*
+    A uniform grid over the play area, the broadphase of the collisions in a level. What can be hit is added to its
+    layer every tick, and a query with a rect only tests what is in the cells the rect covers, so the cost follows
+    the number of things that are close instead of all of them. A query that is nowhere near anything in the layer
+    is turned away by the bounds of the whole layer with a single test.
+    A rect that covers several cells is in every one of them, but a query still reports it once.
+    The cells of a layer are packed into one array (counting sort), and built the first time the layer is queried
+    after something was added. Things outside the area go into the cells at its border. The rects of a cell are
+    packed next to each other too, so a query tests a whole cell at once with the batch kernel.
+*/
+class CollisionGrid {
+    private:
+        struct Layer {
+            ArenaVector<CollisionEntry> entries;
+            // the entries of cell c are items[starts[c]] up to items[starts[c + 1]].
+            ArenaVector<int> starts;
+            ArenaVector<int> items;
+            // the rect of every item.
+            RectBatch rects;
+            // the last query that found every entry, so an entry in several cells is reported once.
+            ArenaVector<int> marks;
+            // the rect around all the entries.
+            SDL_Rect bounds = {};
+            int query = 0;
+            bool built = true;
+
+            Layer(Arena * arena = nullptr) : entries(arena), starts(arena), items(arena), rects(arena), marks(arena) {}
+        };
+
+        int cell_size;
+        int columns = 0, rows = 0;
+        int width = 0, height = 0;
+        Layer layers[COLLISION_LAYER_COUNT];
+
+        void Build(Layer &layer);
+        void Cells(const SDL_Rect &rect, int * x0, int * y0, int * x1, int * y1);
+
+    public:
+        CollisionGrid(Arena * arena, int cell_size = 32);
+
+        // empties every layer, and fits the grid to the play area.
+        void Begin(int width, int height);
+        void Add(CollisionLayer layer, int index, const SDL_Rect &rect);
+
+        // calls found with the index of every entry of the layer that intersects rect, once for each.
+        template <class F>
+        void Query(CollisionLayer layer, const SDL_Rect &rect, F found){
+            Layer &cells = layers[layer];
+            if (!cells.built){
+                Build(cells);
+            }
+            if (!SDL_HasIntersection(&cells.bounds, &rect)){
+                return;
+            }
+            int query = ++cells.query;
+            int x0, y0, x1, y1;
+            Cells(rect, &x0, &y0, &x1, &y1);
+            for (int y = y0; y <= y1; y++){
+                for (int x = x0; x <= x1; x++){
+                    int cell = y * columns + x;
+                    // 32 items at a time, one bit for each.
+                    for (int item = cells.starts[cell]; item < cells.starts[cell + 1]; item += 32){
+                        Uint32 hits;
+                        OverlapMask(rect, cells.rects, item, min(32, cells.starts[cell + 1] - item), &hits);
+                        while (hits){
+                            int e = cells.items[item + __builtin_ctz(hits)];
+                            hits &= hits - 1;
+                            if (cells.marks[e] != query){
+                                cells.marks[e] = query;
+                                found(cells.entries[e].index);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+};
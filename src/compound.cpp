@@ -0,0 +1,136 @@
+#include "compound.h"
+#include "collision.h"
+#include <climits>
+
+CompoundHitboxes::CompoundHitboxes(Arena * arena)
+: hitboxes(arena), nodes(arena), rects(arena), core(arena), order(arena) {}
+
+int CompoundHitboxes::Add(const HitboxPart * parts, int count, const SDL_Rect &source, int w, int h){
+    for (int k = 0; k < int(hitboxes.size()); k++){
+        if (hitboxes[k].source == parts && hitboxes[k].w == w && hitboxes[k].h == h){
+            return k;
+        }
+    }
+    count = min(count, MAX_HITBOX_PARTS);
+
+    Hitbox hitbox;
+    hitbox.source = parts;
+    hitbox.w = w;
+    hitbox.h = h;
+    hitbox.first_part = int(rects.size());
+    hitbox.part_count = count;
+    // scaled the way the sprite is, a part covers every pixel it is drawn on.
+    for (int p = 0; p < count; p++){
+        const SDL_Rect &part = parts[p].rect;
+        int x0 = part.x * w / source.w, y0 = part.y * h / source.h;
+        int x1 = ((part.x + part.w) * w + source.w - 1) / source.w;
+        int y1 = ((part.y + part.h) * h + source.h - 1) / source.h;
+        rects.push_back({x0, y0, x1 - x0, y1 - y0});
+        core.push_back(parts[p].core);
+        order.push_back(p);
+    }
+    hitbox.root = int(nodes.size());
+    if (count){
+        Build(hitbox.first_part, hitbox.first_part, hitbox.first_part + count);
+    }
+    hitboxes.push_back(hitbox);
+    return int(hitboxes.size()) - 1;
+}
+
+// the node around order[begin] up to order[end], and the ones under it. The parts are split in two at the middle
+// of their centers along the longer side, until a leaf has one or two.
+int CompoundHitboxes::Build(int first_part, int begin, int end){
+    int index = int(nodes.size());
+    nodes.push_back({});
+
+    int x0 = INT_MAX, y0 = INT_MAX, x1 = INT_MIN, y1 = INT_MIN;
+    Uint64 bits = 0;
+    for (int k = begin; k < end; k++){
+        const SDL_Rect &rect = rects[first_part + order[k]];
+        x0 = min(x0, rect.x);
+        y0 = min(y0, rect.y);
+        x1 = max(x1, rect.x + rect.w);
+        y1 = max(y1, rect.y + rect.h);
+        bits |= Uint64(1) << order[k];
+    }
+
+    Node node;
+    node.bounds = {x0, y0, x1 - x0, y1 - y0};
+    node.parts = bits;
+    node.first = begin;
+    node.count = 0;
+    if (end - begin <= 2){
+        node.count = end - begin;
+    }
+    else {
+        bool along_x = x1 - x0 >= y1 - y0;
+        int middle = (begin + end) / 2;
+        // twice the center, so it stays an int.
+        auto center = [&](int part){
+            const SDL_Rect &rect = rects[first_part + part];
+            return along_x ? 2 * rect.x + rect.w : 2 * rect.y + rect.h;
+        };
+        nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&](int a, int b){
+            return center(a) != center(b) ? center(a) < center(b) : a < b;
+        });
+        Build(first_part, begin, middle);
+        Build(first_part, middle, end);
+    }
+    node.skip = int(nodes.size());
+    nodes[index] = node;
+    return index;
+}
+
+int CompoundHitboxes::Parts(int hitbox){
+    return hitboxes[hitbox].part_count;
+}
+
+Uint64 CompoundHitboxes::AllParts(int hitbox){
+    int count = hitboxes[hitbox].part_count;
+    return count >= 64 ? ~Uint64(0) : (Uint64(1) << count) - 1;
+}
+
+bool CompoundHitboxes::Core(int hitbox, int part){
+    return core[hitboxes[hitbox].first_part + part];
+}
+
+SDL_Rect CompoundHitboxes::Part(int hitbox, int part){
+    return rects[hitboxes[hitbox].first_part + part];
+}
+
+bool CompoundHitboxes::Sweep(int hitbox, Uint64 alive, int x, int y, const SDL_Rect &start, int dx, int dy, double * time, int * part){
+    const Hitbox &box = hitboxes[hitbox];
+    if (!box.part_count){
+        return false;
+    }
+    // into local space, so the tree doesn't move with the entity.
+    SDL_Rect local = {start.x - x, start.y - y, start.w, start.h};
+    double first = 2.0;
+    int found = -1;
+    int end = nodes[box.root].skip;
+    for (int n = box.root; n < end;){
+        const Node &node = nodes[n];
+        double t;
+        if (!(node.parts & alive) || !SweepRect(local, dx, dy, node.bounds, &t) || t > first){
+            n = node.skip;
+            continue;
+        }
+        for (int k = node.first; k < node.first + node.count; k++){
+            int p = order[k];
+            if (alive >> p & 1 && SweepRect(local, dx, dy, rects[box.first_part + p], &t)){
+                // parts reached at the same moment go to the lower id, wherever they are in the tree.
+                if (t < first || (t == first && p < found)){
+                    first = t;
+                    found = p;
+                }
+            }
+        }
+        n++;
+    }
+    if (found < 0){
+        return false;
+    }
+    *time = first;
+    *part = found;
+    return true;
+}
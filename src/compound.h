@@ -0,0 +1,75 @@
+#pragma once
+#include "headers.h"
+#include "arena.h"
+
+// One part of a compound hitbox, in the pixels of the source rect of the sprite. Losing a core part destroys the
+// whole entity, the others are only shot off.
+struct HitboxPart {
+    SDL_Rect rect;
+    bool core;
+};
+
+// a compound hitbox has at most this many parts, one bit each.
+constexpr int MAX_HITBOX_PARTS = 64;
+
+/*
+    Hitboxes made of many parts that are hit one at a time (turrets, shields, a core), for entities too big for a
+    single rect. The parts of a hitbox are kept in a small bounding volume hierarchy in local space, from the top left
+    corner of the rect the entity is drawn in: every node has the rect around the parts under it, and a leaf holds one
+    or two parts. A projectile is swept against the root first and only goes down where it overlaps, so one that
+    misses costs a single test and one that hits about two per level of the tree.
+    The nodes are stored depth first, so the first child of a node is the node after it, and every node knows where
+    the nodes under it end, which lets the walk skip a whole subtree without a stack. Every node also has a bit for
+    each part under it, so a subtree whose parts were all shot off is skipped the same way.
+
+    A hitbox is built once for every size its parts are drawn at, when the entity is made, and every hitbox of a
+    level is kept in the same arrays.
+*/
+class CompoundHitboxes {
+    private:
+        struct Node {
+            SDL_Rect bounds;
+            // a bit for every part under the node.
+            Uint64 parts;
+            // the parts of a leaf are order[first] up to order[first + count], an inner node has none.
+            int first, count;
+            // the node after the last one under this one.
+            int skip;
+        };
+
+        struct Hitbox {
+            const HitboxPart * source;
+            int w, h;
+            // its nodes are nodes[root] up to nodes[nodes[root].skip], its parts (by part id) are rects[first_part] on.
+            int root;
+            int first_part;
+            int part_count;
+        };
+
+        ArenaVector<Hitbox> hitboxes;
+        ArenaVector<Node> nodes;
+        // the parts at the size they are drawn at, and the part ids of the leaves.
+        ArenaVector<SDL_Rect> rects;
+        ArenaVector<Uint8> core;
+        ArenaVector<int> order;
+
+        int Build(int first_part, int begin, int end);
+
+    public:
+        CompoundHitboxes(Arena * arena);
+
+        // the parts given in the pixels of source, drawn w by h. The same parts at the same size give the same hitbox.
+        int Add(const HitboxPart * parts, int count, const SDL_Rect &source, int w, int h);
+        int Parts(int hitbox);
+        // a bit for every part of the hitbox.
+        Uint64 AllParts(int hitbox);
+        bool Core(int hitbox, int part);
+        // the part rect in local space.
+        SDL_Rect Part(int hitbox, int part);
+
+        /*
+            Sweeps start by (dx, dy) against the alive parts of the hitbox placed at where (x, y). True when it hits
+            one, part is the one it reaches first and time is when, from 0 to 1 like SweepRect.
+        */
+        bool Sweep(int hitbox, Uint64 alive, int x, int y, const SDL_Rect &start, int dx, int dy, double * time, int * part);
+};
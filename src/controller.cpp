@@ -1,4 +1,5 @@
 #include "controller.h"
+#include "profiler.h"
 
 Controller::Controller(int i){
     // buttons on a controller
@@ -40,26 +41,26 @@ Controller::~Controller(){
 
 void Controller::ProcessButtons(){
     previous_button_state = current_button_state;
-    for (auto button: button_map){
+    for (auto &button: button_map){
         current_button_state[button.first] = SDL_GameControllerGetButton(instance, button.second);
     }
 }
 
-bool Controller::GetButtonPressed(string button){
+bool Controller::GetButtonPressed(const string & button){
     return current_button_state[button];
 }
 
-bool Controller::GetButtonWasPressed(string button){
+bool Controller::GetButtonWasPressed(const string & button){
     return !previous_button_state[button] && current_button_state[button];
 }
 
-vector<double> Controller::GetAnalogStick(string stick){
+vector<double> Controller::GetAnalogStick(const string & stick){
     double x = SDL_GameControllerGetAxis(instance, analog_map[stick][0]) / ((0xFFFF)/2);
     double y = SDL_GameControllerGetAxis(instance, analog_map[stick][1]) / ((0xFFFF)/2);
     return {x, y};
 }
 
-double Controller::GetTrigger(string trigger){
+double Controller::GetTrigger(const string & trigger){
     return SDL_GameControllerGetAxis(instance, trigger_map[trigger]) / ((0xFFFF)/2); 
 }
 
@@ -68,7 +69,11 @@ void Controller::SetRumble(double left_motor, double right_motor, double seconds
 }
 
 
-ControllerManager::ControllerManager(){
+ControllerManager::ControllerManager(bool open_devices){
+    // in headless mode there are no devices to open.
+    if (!open_devices){
+        return;
+    }
     cout << SDL_NumJoysticks() << endl;
     for(int i = 0; i < SDL_NumJoysticks(); i++){
         if (i >= 4){break;}
@@ -84,11 +89,13 @@ ControllerManager::~ControllerManager(){
 }
 
 void ControllerManager::Add(SDL_Event * event){
+    lock_guard<mutex> guard(lock);
     controllers.push_back(new Controller(event->cdevice.which));
     number_of_controllers += 1;
 }
 
 void ControllerManager::Remove(SDL_Event * event){
+    lock_guard<mutex> guard(lock);
     for (int i = 0; i < number_of_controllers; i++){
         if (controllers[i]->instance_id == event->cdevice.which){
             delete controllers[i];
@@ -110,19 +117,20 @@ void ControllerManager::ProcessControllerEvents(SDL_Event * event){
 }
 
 void ControllerManager::ProcessControllerButtonState(){
+    PROFILE_ZONE("Controller buttons");
     for (auto controller: controllers){
         controller->ProcessButtons();
     }
 }
 
-bool ControllerManager::GetControllerButtonPressed(int i, string button){
+bool ControllerManager::GetControllerButtonPressed(int i, const string & button){
     if ((0 <= i) && (i <= number_of_controllers-1)){
         return controllers[i]->GetButtonPressed(button);
     }
     return false;
 }
 
-bool ControllerManager::GetControllerButtonWasPressed(int i, string button){
+bool ControllerManager::GetControllerButtonWasPressed(int i, const string & button){
     if ((0 <= i) && (i <= number_of_controllers-1)){
         return controllers[i]->GetButtonWasPressed(button);
     }
@@ -130,6 +138,7 @@ bool ControllerManager::GetControllerButtonWasPressed(int i, string button){
 }
 
 void ControllerManager::SetControllerRumble(int i, double left_motor, double right_motor, double seconds){
+    lock_guard<mutex> guard(lock);
     if ((0 <= i) && (i <= number_of_controllers-1)){
         return controllers[i]->SetRumble(left_motor, right_motor, seconds);
     }
@@ -15,10 +15,11 @@ class Controller {
         ~Controller();
 
         void ProcessButtons();
-        bool GetButtonPressed(string);
-        bool GetButtonWasPressed(string);
-        vector<double> GetAnalogStick(string);
-        double GetTrigger(string);
+        // the names are taken by reference, they are looked up every tick.
+        bool GetButtonPressed(const string &);
+        bool GetButtonWasPressed(const string &);
+        vector<double> GetAnalogStick(const string &);
+        double GetTrigger(const string &);
 
         // The values for the left motor and the right motor are up to 100.
         void SetRumble(double left, double right, double seconds);
@@ -29,17 +30,19 @@ class ControllerManager {
     private:
         vector<Controller *> controllers;
         int number_of_controllers = 0;
+        // controllers are added and removed on the event thread, while rumble is set from the simulation thread.
+        mutex lock;
     
     public:
-        ControllerManager();
+        ControllerManager(bool open_devices = true);
         ~ControllerManager();
 
         void ProcessControllerEvents(SDL_Event *);
         void Add(SDL_Event *);
         void Remove(SDL_Event *);
         void ProcessControllerButtonState();
-        bool GetControllerButtonPressed(int, string);
-        bool GetControllerButtonWasPressed(int, string);
+        bool GetControllerButtonPressed(int, const string &);
+        bool GetControllerButtonWasPressed(int, const string &);
 
         void SetControllerRumble(int, double, double, double);
 
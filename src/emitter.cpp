@@ -0,0 +1,201 @@
+#include "emitter.h"
+
+const EmitterPattern emitter_patterns[EMITTER_PATTERN_COUNT] = {
+    //  name       shape            count  spread  heading  spin  interval  speed  size  max projectiles
+    {"ring",     EMITTER_SPREAD,  24,    360,    270,     0,    1.2,      2,     10,   96},
+    {"fan",      EMITTER_SPREAD,  7,     60,     270,     0,    .8,       3,     10,   64},
+    {"spiral",   EMITTER_SPIRAL,  4,     360,    270,     11,   .1,       2,     10,   320},
+    {"aimed",    EMITTER_AIMED,   3,     20,     270,     0,    .6,       4,     10,   32},
+};
+
+static const int trig_table_size = 1 << TRIG_TABLE_BITS;
+
+// one turn of sine, the cosine is the same table a quarter turn on.
+struct SineTable {
+    float values[trig_table_size];
+
+    SineTable(){
+        for (int k = 0; k < trig_table_size; k++){
+            values[k] = float(sin(2 * M_PI * k / trig_table_size));
+        }
+    }
+};
+
+static const SineTable sine_table;
+
+BinaryAngle DegreesToAngle(double degrees){
+    // wraps negative angles and angles past a turn the same way.
+    return BinaryAngle(Sint64(llround(degrees / 360 * 65536)));
+}
+
+float TableSin(BinaryAngle angle){
+    return sine_table.values[angle >> (16 - TRIG_TABLE_BITS)];
+}
+
+float TableCos(BinaryAngle angle){
+    return sine_table.values[BinaryAngle(angle + 16384) >> (16 - TRIG_TABLE_BITS)];
+}
+
+ProjectileField::ProjectileField(Arena * arena)
+: flags(arena), x(arena), y(arena), last_x(arena), last_y(arena), velocity_x(arena), velocity_y(arena), half(arena), hit(arena) {}
+
+void ProjectileField::Reserve(int capacity){
+    // only done while the emitters are made, the arrays are walked by index and never grow in play. They are as
+    // long as whole blocks, the projectiles past the count in the last block are moved along but never used.
+    this->capacity = capacity;
+    int size = (capacity + FIELD_BLOCK - 1) / FIELD_BLOCK * FIELD_BLOCK;
+    flags.resize(size);
+    x.resize(size);
+    y.resize(size);
+    last_x.resize(size);
+    last_y.resize(size);
+    velocity_x.resize(size);
+    velocity_y.resize(size);
+    half.resize(size);
+    hit.resize(size);
+}
+
+int ProjectileField::Capacity(){
+    return capacity;
+}
+
+void ProjectileField::Spawn(float x_pos, float y_pos, float vx, float vy, float h){
+    x[count] = x_pos;
+    y[count] = y_pos;
+    last_x[count] = x_pos;
+    last_y[count] = y_pos;
+    velocity_x[count] = vx;
+    velocity_y[count] = vy;
+    half[count] = h;
+    hit[count] = false;
+    count++;
+}
+
+int ProjectileField::Emit(const EmitterPattern &pattern, double x_pos, double y_pos, BinaryAngle heading, double target_x, double target_y){
+    // the direction the volley is fanned around, as a vector with y going up.
+    float forward_x = TableCos(heading), forward_y = TableSin(heading);
+    if (pattern.shape == EMITTER_AIMED){
+        double dx = target_x - x_pos, dy = y_pos - target_y;
+        double length = sqrt(dx * dx + dy * dy);
+        if (length > 0){
+            forward_x = float(dx / length);
+            forward_y = float(dy / length);
+        }
+    }
+
+    int count_fired = min(pattern.count, capacity - count);
+    // a whole ring is split evenly, so the last projectile doesn't land on the first.
+    int spread = int(llround(pattern.spread / 360 * 65536));
+    int step = spread >= 65536 ? 65536 / max(1, pattern.count) : (pattern.count > 1 ? spread / (pattern.count - 1) : 0);
+    int first = spread >= 65536 ? 0 : -spread / 2;
+    float speed = float(pattern.speed * 100);
+    float h = pattern.size / 2.0f;
+    for (int k = 0; k < count_fired; k++){
+        // every projectile turns the forward direction by its place in the fan.
+        BinaryAngle turn = BinaryAngle(first + k * step);
+        float c = TableCos(turn), s = TableSin(turn);
+        float direction_x = forward_x * c - forward_y * s;
+        float direction_y = forward_x * s + forward_y * c;
+        Spawn(float(x_pos), float(y_pos), direction_x * speed, -direction_y * speed, h);
+    }
+    return count_fired;
+}
+
+/*
+    The loops over the whole field take the arrays as pointers that don't alias, or the compiler has to assume that
+    the flags (bytes) overwrite everything else, and go over whole blocks, so they are vectorized without a scalar
+    tail even at -O2.
+*/
+// moves every projectile from where it is to where it goes, and flags the ones that are gone, without branches.
+static void MoveBlocks(int count, float step, float right, float bottom,
+                       const float * __restrict from_x, const float * __restrict from_y, float * __restrict to_x, float * __restrict to_y,
+                       const float * __restrict vx, const float * __restrict vy, const float * __restrict half,
+                       const Uint8 * __restrict hit, Uint8 * __restrict gone){
+    for (int block = 0; block < count; block += FIELD_BLOCK){
+        for (int i = block; i < block + FIELD_BLOCK; i++){
+            float nx = from_x[i] + vx[i] * step, ny = from_y[i] + vy[i] * step;
+            to_x[i] = nx;
+            to_y[i] = ny;
+            gone[i] = hit[i] | (nx + half[i] < 0) | (nx - half[i] > right) | (ny + half[i] < 0) | (ny - half[i] > bottom);
+        }
+    }
+}
+
+// flags the projectiles whose swept rect overlaps the one from left, top to right, bottom.
+static void NearBlocks(int count, float left, float top, float right, float bottom,
+                       const float * __restrict x, const float * __restrict y, const float * __restrict last_x,
+                       const float * __restrict last_y, const float * __restrict half, Uint8 * __restrict near){
+    for (int block = 0; block < count; block += FIELD_BLOCK){
+        for (int i = block; i < block + FIELD_BLOCK; i++){
+            float x0 = min(x[i], last_x[i]) - half[i], x1 = max(x[i], last_x[i]) + half[i];
+            float y0 = min(y[i], last_y[i]) - half[i], y1 = max(y[i], last_y[i]) + half[i];
+            near[i] = (x0 < right) & (x1 > left) & (y0 < bottom) & (y1 > top);
+        }
+    }
+}
+
+void ProjectileField::Process(double seconds, int width, int height){
+    // the new positions go into the arrays of the last positions, which are then swapped with the positions, so
+    // nothing is copied.
+    MoveBlocks(count, float(seconds), float(width), float(height), x.data(), y.data(), last_x.data(), last_y.data(),
+               velocity_x.data(), velocity_y.data(), half.data(), hit.data(), flags.data());
+    x.swap(last_x);
+    y.swap(last_y);
+
+    // the ones that are gone are swapped with the last one, like in a ProjectilePool, so only they cost anything.
+    // Going from the end, the last one has always been looked at already. The flags are read 8 at a time.
+    for (int i = (count - 1) & ~7; i >= 0; i -= 8){
+        Uint64 word;
+        memcpy(&word, &flags[i], sizeof(word));
+        while (word){
+            int bit = 63 - __builtin_clzll(word);
+            word &= ~(Uint64(1) << bit);
+            if (i + bit / 8 < count){
+                Remove(i + bit / 8);
+            }
+        }
+    }
+}
+
+void ProjectileField::Remove(int i){
+    int last = --count;
+    x[i] = x[last];
+    y[i] = y[last];
+    last_x[i] = last_x[last];
+    last_y[i] = last_y[last];
+    velocity_x[i] = velocity_x[last];
+    velocity_y[i] = velocity_y[last];
+    half[i] = half[last];
+    hit[i] = hit[last];
+}
+
+void ProjectileField::FlagNear(const SDL_Rect &rect){
+    // loose by a couple of pixels, for the rounding of the rects.
+    NearBlocks(count, rect.x - 2, rect.y - 2, rect.x + rect.w + 2, rect.y + rect.h + 2, x.data(), y.data(), last_x.data(),
+               last_y.data(), half.data(), flags.data());
+}
+
+void ProjectileField::Clear(){
+    count = 0;
+}
+
+SDL_Rect ProjectileField::Rect(int i){
+    // placed around its center the way a Projectile places its hitbox.
+    int size = int(half[i] * 2);
+    return {int(x[i] - int(size / 2)), int(y[i] - int(size / 2)), size, size};
+}
+
+SDL_Rect ProjectileField::LastRect(int i){
+    int size = int(half[i] * 2);
+    return {int(last_x[i] - int(size / 2)), int(last_y[i] - int(size / 2)), size, size};
+}
+
+SDL_Rect ProjectileField::SweptRect(int i){
+    SDL_Rect last = LastRect(i), now = Rect(i);
+    SDL_Rect swept;
+    swept.x = min(last.x, now.x);
+    swept.y = min(last.y, now.y);
+    swept.w = max(last.x + last.w, now.x + now.w) - swept.x;
+    swept.h = max(last.y + last.h, now.y + now.h) - swept.y;
+    return swept;
+}
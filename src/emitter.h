@@ -0,0 +1,126 @@
+#pragma once
+#include "headers.h"
+#include "arena.h"
+
+/*
+    Angles of the emitters are binary, a whole turn is 65536, so they wrap around on their own and the top bits index
+    the sine table. 0 points right and a quarter turn points up, like the degrees of a Projectile.
+*/
+typedef Uint16 BinaryAngle;
+
+constexpr int TRIG_TABLE_BITS = 12;
+// the projectiles of a field are moved in blocks of this many, as many bytes as a vector register has.
+constexpr int FIELD_BLOCK = 16;
+
+BinaryAngle DegreesToAngle(double degrees);
+// looked up in a table of 4096 steps per turn, filled once when the program starts.
+float TableSin(BinaryAngle angle);
+float TableCos(BinaryAngle angle);
+
+enum EmitterShape {
+    // fanned over the spread around a heading that doesn't change (a spread of 360 is a whole ring).
+    EMITTER_SPREAD,
+    // like a spread, but the heading turns by the spin after every volley.
+    EMITTER_SPIRAL,
+    // fanned over the spread around the direction of the target.
+    EMITTER_AIMED,
+};
+
+enum EmitterPatternId {
+    PATTERN_RING,
+    PATTERN_FAN,
+    PATTERN_SPIRAL,
+    PATTERN_AIMED,
+    EMITTER_PATTERN_COUNT
+};
+
+// How an emitter fires, a kind of enemy names the pattern it fires with.
+struct EmitterPattern {
+    const char * name;
+    EmitterShape shape;
+    // projectiles in every volley, and the degrees they are fanned over.
+    int count;
+    double spread;
+    // the degrees the emitter faces before its first volley, 270 is straight down.
+    double heading;
+    // degrees the heading turns after every volley.
+    double spin;
+    // seconds between volleys.
+    double interval;
+    // like the speed of a Projectile, a hundred pixels per second.
+    int speed;
+    // the width and height of every projectile.
+    int size;
+    // the room an emitter with this pattern takes in the field, how many of its projectiles can fly at once.
+    int max_projectiles;
+};
+
+extern const EmitterPattern emitter_patterns[EMITTER_PATTERN_COUNT];
+
+/*
+    Every projectile the emitters fired, stored as parallel arrays: projectile i is at x[i], y[i] and so on. A
+    projectile keeps the velocity it was fired with, worked out once from the table when it is fired, so moving all
+    of them is one pass of multiply-adds over the arrays that the compiler vectorizes, without any trig per tick.
+    The same pass flags the ones that left the screen or hit something, and those are swapped with the last one
+    afterwards, so the live projectiles are always the first count.
+    Positions are floats, so a vector register holds twice as many of them.
+
+    The room is reserved when the emitters are made and the arrays never grow after that, a full field doesn't fire.
+*/
+class ProjectileField {
+    private:
+        int capacity = 0;
+        // a flag for every projectile, from the pass that moves them and from a query.
+        ArenaVector<Uint8> flags;
+
+        void Spawn(float x, float y, float velocity_x, float velocity_y, float half);
+        // sets the flag of every projectile that may touch rect, in one pass over the field.
+        void FlagNear(const SDL_Rect &rect);
+        void Remove(int i);
+
+    public:
+        int count = 0;
+        ArenaVector<float> x, y;
+        ArenaVector<float> last_x, last_y;
+        ArenaVector<float> velocity_x, velocity_y;
+        // half the width (and height) of every projectile.
+        ArenaVector<float> half;
+        // a projectile that hit something is taken out of the field when it is processed.
+        ArenaVector<Uint8> hit;
+
+        ProjectileField(Arena * arena = nullptr);
+        void Reserve(int capacity);
+        int Capacity();
+
+        /*
+            Fires a volley of the pattern from (x, y), the emitter faces heading. An aimed pattern faces the target
+            instead. Returns how many were fired, fewer than the pattern has when the field is full.
+        */
+        int Emit(const EmitterPattern &pattern, double x, double y, BinaryAngle heading, double target_x, double target_y);
+        // moves every projectile, and takes out the ones that hit something or left the width by height screen.
+        void Process(double seconds, int width, int height);
+        void Clear();
+
+        // the hitbox of a projectile, where it was at the start of the tick and all it swept over during the tick.
+        SDL_Rect Rect(int i);
+        SDL_Rect LastRect(int i);
+        SDL_Rect SweptRect(int i);
+
+        // calls found with every projectile whose swept rect may touch rect. The test is loose by a couple of pixels,
+        // so it finds every one whose rect (rounded to whole pixels) does. Only the few it finds cost a call.
+        template <class F>
+        void Query(const SDL_Rect &rect, F found){
+            FlagNear(rect);
+            // the flags are read 8 at a time, almost all of them are clear. They go on to the end of the block.
+            for (int i = 0; i < count; i += 8){
+                Uint64 word;
+                memcpy(&word, &flags[i], sizeof(word));
+                for (; word; word &= word - 1){
+                    int p = i + __builtin_ctzll(word) / 8;
+                    if (p < count){
+                        found(p);
+                    }
+                }
+            }
+        }
+};
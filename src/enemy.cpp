@@ -1,250 +1,411 @@
 #include "enemy.h"
 #include "math.h"
 #include "player.h"
+#include "profiler.h"
+
+// the mothership is the villain1 ship drawn big: a core that takes the ship with it, and the armour, guns and
+// wings around it that are shot off first. From below the guns and the lower armour cover most of the core.
+static const HitboxPart mothership_parts[] = {
+    //  rect                 core
+    {{12, 10, 16, 14},   true},     // core
+    {{0, 28, 10, 8},     false},    // left gun
+    {{28, 28, 10, 8},    false},    // right gun
+    {{16, 28, 8, 12},    false},    // cannon
+    {{0, 22, 14, 6},     false},    // left armour
+    {{24, 22, 14, 6},    false},    // right armour
+    {{0, 10, 12, 12},    false},    // left wing
+    {{28, 10, 12, 12},   false},    // right wing
+    {{4, 0, 32, 10},     false},    // crown
+};
+
+const EnemyKindInfo enemy_kinds[ENEMY_KIND_COUNT] = {
+    //  name          sprite                     source rect         speed  projectile speed  max projectiles  cooldown  pattern         parts
+    {"villain1",    "resources/villain1.bmp",  {30, 24, 40, 40},   7,     3,                2,               .3,       -1,             nullptr, 0},
+    {"villain2",    "resources/villain2.bmp",  {15, 15, 20, 20},   7,     3,                1,               .3,       -1,             nullptr, 0},
+    {"mothership",  "resources/villain1.bmp",  {30, 24, 40, 40},   7,     3,                4,               .3,       PATTERN_SPIRAL,
+     mothership_parts, int(sizeof(mothership_parts) / sizeof(mothership_parts[0]))},
+};
+
+// which way every direction moves along x and y.
+static const double direction_x[] = {0, -1, 1, 0, 0};
+static const double direction_y[] = {0, 0, 0, -1, 1};
+
+EnemyKind FindEnemyKind(string name){
+    for (int k = 0; k < ENEMY_KIND_COUNT; k++){
+        if (name == enemy_kinds[k].name){
+            return EnemyKind(k);
+        }
+    }
+    return ENEMY_KIND_COUNT;
+}
 
-Enemy::Enemy(SpriteCache * cache, int x, int y, int w, int h, string src, string t, Player * player){
-    renderer = cache->renderer;
-    type = t;
-    this->player = player;
+EnemyStore::EnemyStore(Arena * arena, SpriteCache * cache)
+: hitboxes(arena), id(arena), slot(arena), kind(arena), state(arena), moving(arena), direction(arena), x(arena), y(arena), last_x(arena), last_y(arena),
+  velocity_x(arena), velocity_y(arena), speed(arena), default_speed(arena), attack_cooldown(arena), cooldown_timer(arena),
+  cooldown_time(arena), playheads(arena), rects(arena), masks(arena), hitbox(arena), parts(arena), width(arena), height(arena), starting_x(arena), starting_y(arena),
+  projectile_count(arena), bullets(arena), field(arena), emitter_timer(arena), emitter_heading(arena) {
     this->cache = cache;
 
-    x_pos = x;
-    y_pos = y;
-    starting_xpos = x_pos;
-    starting_ypos = y_pos;
-    width = w;
-    height = h;
-
-    d_rect.x = x;
-    d_rect.y = y;
-    d_rect.w = w;
-    d_rect.h = h;
+    // every kind of enemy explodes the same way.
+    int explosion = cache->AddClip("resources/explosion.bmp", {0, 0, 64, 64}, 64, 4, .1, 60);
+    for (int k = 0; k < ENEMY_KIND_COUNT; k++){
+        kind_clips[k][ENEMY_DEFAULT] = cache->AddClip(enemy_kinds[k].sprite, enemy_kinds[k].s_rect);
+        kind_clips[k][ENEMY_DYING] = explosion;
+        for (int st = 0; st < ENEMY_STATE_COUNT; st++){
+            kind_grow[k][st] = cache->GetClip(kind_clips[k][st]).grow;
+        }
+    }
+    projectile_clips[VILLAIN1] = Blaster::Clip(cache);
+    projectile_clips[VILLAIN2] = Laser2::Clip(cache);
+    projectile_clips[MOTHERSHIP] = projectile_clips[VILLAIN1];
+    field_clip = projectile_clips[VILLAIN1];
+    cache->Play(&field_playhead, field_clip);
+}
 
-    sprites["DEFAULT"] = nullptr;
-    sprites["DYING"] = nullptr;
-    state = "";
-    default_speed = 7;
-    speed = default_speed;
-    projectile_speed = 4;
-    cooldown_time = .3;
+int EnemyStore::Add(EnemyKind k, int x_pos, int y_pos, int w, int h){
+    id.push_back(count);
+    slot.push_back(count);
+    kind.push_back(k);
+    state.push_back(ENEMY_DEFAULT);
+    moving.push_back(false);
+    direction.push_back(DIRECTION_NONE);
+    x.push_back(x_pos);
+    y.push_back(y_pos);
+    last_x.push_back(x_pos);
+    last_y.push_back(y_pos);
+    velocity_x.push_back(0.0);
+    velocity_y.push_back(0.0);
+    speed.push_back(enemy_kinds[k].speed);
+    default_speed.push_back(enemy_kinds[k].speed);
+    attack_cooldown.push_back(false);
+    cooldown_timer.push_back(0.0);
+    cooldown_time.push_back(enemy_kinds[k].cooldown_time);
+    rects.push_back({x_pos, y_pos, w, h});
+    int grow = kind_grow[k][ENEMY_DEFAULT];
+    masks.push_back(cache->AddMask(kind_clips[k][ENEMY_DEFAULT], w + grow, h + grow));
+    if (enemy_kinds[k].part_count){
+        hitbox.push_back(hitboxes.Add(enemy_kinds[k].parts, enemy_kinds[k].part_count, enemy_kinds[k].s_rect, w + grow, h + grow));
+        parts.push_back(hitboxes.AllParts(hitbox.back()));
+    }
+    else {
+        hitbox.push_back(-1);
+        parts.push_back(0);
+    }
+    width.push_back(w);
+    height.push_back(h);
+    starting_x.push_back(x_pos);
+    starting_y.push_back(y_pos);
+    projectile_count.push_back(0);
+    bullets.Reserve(bullets.Capacity() + enemy_kinds[k].max_projectiles);
+    int pattern = enemy_kinds[k].pattern;
+    emitter_timer.push_back(0.0);
+    emitter_heading.push_back(pattern >= 0 ? DegreesToAngle(emitter_patterns[pattern].heading) : 0);
+    if (pattern >= 0){
+        field.Reserve(field.Capacity() + emitter_patterns[pattern].max_projectiles);
+    }
 
+    Playhead playhead;
+    cache->Play(&playhead, kind_clips[k][ENEMY_DEFAULT]);
+    playheads.push_back(playhead);
+    active++;
+    return count++;
 }
 
-void Enemy::Process(Clock * clock, int height){
-    // Animate the current sprite if it has an animation 
-    sprites[state]->Animate(clock);
+int EnemyStore::Clip(int i){
+    return kind_clips[kind[i]][state[i]];
+}
 
-    // If dying animation finished, the enemy is dead.
-    if (state == "DYING"){
-        if (sprites[state]->finished){
-            dead = true;
-        }
-        moving = false;
+void EnemyStore::Move(int i, Direction d){
+    if (d == DIRECTION_NONE)
+        moving[i] = false;
+    else{
+        moving[i] = true;
+        direction[i] = d;
     }
+}
 
-    if (dead){
-        x_pos = 0;
-        y_pos = 0;
-    }
+void EnemyStore::SetPos(int i, int x_pos, int y_pos){
+    x[i] = x_pos;
+    y[i] = y_pos;
+    last_x[i] = x_pos;
+    last_y[i] = y_pos;
+}
 
-    else {
-        if (moving){
-            if (direction == "left"){
-                x_pos -= ((speed * 10) * clock->delta_time_s);
-            }
-            if (direction == "right"){
-                x_pos += ((speed * 10) * clock->delta_time_s);
-            }
-            if (direction == "up"){
-                y_pos -= ((speed * 10) * clock->delta_time_s);
-            }
-            if (direction == "down"){
-                y_pos += ((speed * 10) * clock->delta_time_s);
-            }
-        }
+bool EnemyStore::CanShoot(int i){
+    return y[i] < player->y_pos - 10;
+}
+
+bool EnemyStore::Attack(int i){
+    if (state[i] != ENEMY_DEFAULT || projectile_count[id[i]] >= enemy_kinds[kind[i]].max_projectiles || attack_cooldown[i]){
+        return false;
     }
 
-    // move bullets in the list/vector down screen.
-    int i = 0;
-    for (auto bullet: bullets){
-        bullet->Process(clock);
-        if (bullet->y_pos >= height){
-            if (find(erased.begin(), erased.end(), i) == erased.end()){
-                erased.push_back(i);
+    int projectile_speed = enemy_kinds[kind[i]].projectile_speed;
+    ProjectileHandle fired;
+    switch (kind[i]){
+        case VILLAIN1:
+        case MOTHERSHIP:
+            // shoots straight down, only once it is above the player.
+            if (!CanShoot(i)){
+                return false;
             }
+            fired = bullets.Fire(
+                Blaster(cache, projectile_clips[kind[i]], x[i],
+                                (y[i] + (rects[i].w/2)) - 20, 20, 20, 270, {255, 0, 0, 255}, projectile_speed)
+            );
+            break;
+        case VILLAIN2: {
+            // aims at the player.
+            float angle_to_player = (-atan2((player->y_pos-y[i]), (player->x_pos-x[i]))) * (180 /PI);
+            fired = bullets.Fire(
+                Laser2(cache, projectile_clips[VILLAIN2], x[i],
+                                (y[i] + (rects[i].w/2)) - 10, 15, 20, angle_to_player, {255, 0, 0, 255}, projectile_speed)
+            );
+            break;
         }
-        i++;
+        default:
+            return false;
     }
 
-    // erase bullets if they are off screen.
-    for (auto index: erased){
-        delete bullets[index];
-        bullets.erase(bullets.begin()+index);
+    Projectile * projectile = bullets.Get(fired);
+    if (!projectile){
+        return false;
     }
+    projectile->owner = id[i];
+    projectile_count[id[i]]++;
+    attack_cooldown[i] = true;
+    return true;
+}
 
-    // if there is a cooldown, count down the cooldown until it reaches the limit, then disable the cooldown.
-    // this is done so that an enemy can only add a bullet in certain intervals.
-    if (attack_cooldown){
-        cooldown_timer += clock->delta_time_s;
-        if (cooldown_timer >= cooldown_time){
-            cooldown_timer = 0;
-            attack_cooldown = false;
-        }
+void EnemyStore::Hit(int i){
+    if (state[i] == ENEMY_DEFAULT){
+        destroyed++;
     }
+    state[i] = enemy_transitions[state[i]][ENEMY_HIT];
+}
 
-    erased.clear();
+const CollisionMask & EnemyStore::Mask(int i){
+    int clip = kind_clips[kind[i]][ENEMY_DEFAULT];
+    return cache->GetMask(masks[i] + (playheads[i].clip == clip ? playheads[i].frame : 0));
 }
 
-bool Enemy::canShoot(){
-    return y_pos < player->y_pos - 10;
+bool EnemyStore::Touches(int i, const SDL_Rect &rect){
+    if (state[i] != ENEMY_DEFAULT){
+        return SDL_HasIntersection(&rects[i], &rect);
+    }
+    return MaskTouchesRect(Mask(i), rects[i], rect);
 }
 
-void Enemy::Move(string d){
-    if (d == "none")
-        moving = false;
-    else{
-        moving = true;
-        direction = d;
-    } 
+bool EnemyStore::Compound(int i){
+    return hitbox[i] >= 0;
+}
+
+bool EnemyStore::SweepParts(int i, Projectile &bullet, double * time, int * part){
+    SDL_Rect last = bullet.LastRect();
+    return hitboxes.Sweep(hitbox[i], parts[i], rects[i].x, rects[i].y, last, bullet.hitbox.x - last.x, bullet.hitbox.y - last.y, time, part);
 }
 
-void Enemy::SetPos(int x, int y){
-    x_pos = x;
-    y_pos = y;
+bool EnemyStore::HitPart(int i, int part){
+    parts[i] &= ~(Uint64(1) << part);
+    return hitboxes.Core(hitbox[i], part) || !parts[i];
 }
 
-void Enemy::Reset(){
-    for (auto sprite : sprites){
-        sprite.second->Reset();
+void EnemyStore::Emit(int i, double seconds){
+    int pattern = enemy_kinds[kind[i]].pattern;
+    if (pattern < 0 || state[i] != ENEMY_DEFAULT){
+        return;
     }
-    dead = false;
-    state = "DEFAULT";
-    SetPos(starting_xpos, starting_ypos);
-    for (int i = 0; i < int(bullets.size()); i++){
-        if (find(erased.begin(), erased.end(), i) == erased.end()){
-            delete bullets[i];
-            bullets.erase(bullets.begin() + i);
-        }  
+    const EmitterPattern &fires = emitter_patterns[pattern];
+    emitter_timer[i] += seconds;
+    if (emitter_timer[i] < fires.interval){
+        return;
     }
+    emitter_timer[i] = 0;
+    field.Emit(fires, x[i], y[i], emitter_heading[i], player->x_pos, player->y_pos);
+    emitter_heading[i] += DegreesToAngle(fires.spin);
+}
+
+void EnemyStore::Swap(int a, int b){
+    swap(id[a], id[b]);
+    slot[id[a]] = a;
+    slot[id[b]] = b;
+    swap(kind[a], kind[b]);
+    swap(state[a], state[b]);
+    swap(moving[a], moving[b]);
+    swap(direction[a], direction[b]);
+    swap(x[a], x[b]);
+    swap(y[a], y[b]);
+    swap(last_x[a], last_x[b]);
+    swap(last_y[a], last_y[b]);
+    swap(velocity_x[a], velocity_x[b]);
+    swap(velocity_y[a], velocity_y[b]);
+    swap(speed[a], speed[b]);
+    swap(default_speed[a], default_speed[b]);
+    swap(attack_cooldown[a], attack_cooldown[b]);
+    swap(cooldown_timer[a], cooldown_timer[b]);
+    swap(cooldown_time[a], cooldown_time[b]);
+    swap(playheads[a], playheads[b]);
+    swap(rects[a], rects[b]);
+    swap(masks[a], masks[b]);
+    swap(hitbox[a], hitbox[b]);
+    swap(parts[a], parts[b]);
+    swap(width[a], width[b]);
+    swap(height[a], height[b]);
+    swap(starting_x[a], starting_x[b]);
+    swap(starting_y[a], starting_y[b]);
+    swap(emitter_timer[a], emitter_timer[b]);
+    swap(emitter_heading[a], emitter_heading[b]);
 }
 
-bool Enemy::Attack(){
-    float angle_to_player = 270;
+// takes a dead enemy out of play: it is kept out of the way at the corner, after the active ones.
+void EnemyStore::Deactivate(int i){
+    x[i] = 0;
+    y[i] = 0;
+    last_x[i] = 0;
+    last_y[i] = 0;
+    moving[i] = false;
+    velocity_x[i] = 0;
+    velocity_y[i] = 0;
+    active--;
+    Swap(i, active);
+}
 
-    if (state == "DEFAULT"){
-        if ((int(bullets.size()) < max_projectiles) && !attack_cooldown){
-            bullets.push_back(
-                new Projectile(cache, x_pos,
-                                    (y_pos + (d_rect.w/2)) - 20, 10, 10, angle_to_player, {255, 0, 0, 255}, projectile_speed)
-            );
-            attack_cooldown = true;
-            return true;
+void EnemyStore::Process(Clock * clock, int screen_width, int screen_height){
+    PROFILE_ZONE("EnemyStore::Process");
+    double seconds = clock->delta_time_s;
+
+    // enemies that went off the bottom of the screen start over at the top, where they are along x doesn't change
+    // so they stay in the fleet.
+    for (int i = 0; i < active; i++){
+        if (y[i] >= screen_height){
+            y[i] = 0;
+            last_x[i] = x[i];
+            last_y[i] = 0;
         }
     }
-    return false; 
-}
 
-bool Enemy::TouchingBullet(SDL_Rect * rect){
-    for (auto bullet: bullets){
-        if (SDL_HasIntersection(&bullet->hitbox, rect)){
-            return true;
-        }
+    // keep the position of the last tick so rendering can interpolate between the two.
+    for (int i = 0; i < active; i++){
+        last_x[i] = x[i];
+        last_y[i] = y[i];
     }
-    return false;
-}
 
-void Enemy::Render(){
-    
-    d_rect.x = (x_pos - int(d_rect.w / 2));
-    d_rect.y = (y_pos - int(d_rect.h / 2));
-    d_rect.w = sprites[state]->d_rect.w;
-    d_rect.h = sprites[state]->d_rect.h;
+    // Animate the clip of the current state of every enemy at once.
+    for (int i = 0; i < active; i++){
+        if (playheads[i].clip != Clip(i)){
+            cache->Play(&playheads[i], Clip(i));
+        }
+    }
+    cache->Advance(playheads.data(), active, seconds);
+
+    // If dying animation finished, the enemy is dead and out of play; the one swapped into its place is looked at next.
+    for (int i = 0; i < active;){
+        if (state[i] == ENEMY_DYING){
+            moving[i] = false;
+            if (playheads[i].finished){
+                Deactivate(i);
+                continue;
+            }
+        }
+        i++;
+    }
 
-    // Set the position of the rendered sprite to be the same position as the enemy
-    sprites[state]->SetPos(x_pos, y_pos);
+    for (int i = 0; i < active; i++){
+        double step = moving[i] ? speed[i] * 10 : 0;
+        velocity_x[i] = direction_x[direction[i]] * step;
+        velocity_y[i] = direction_y[direction[i]] * step;
+    }
 
-    // Render any bullets if they exist.
-    for (auto bullet: bullets){
-        bullet->Render();
+    for (int i = 0; i < active; i++){
+        x[i] += velocity_x[i] * seconds;
+        y[i] += velocity_y[i] * seconds;
     }
 
-    //SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
-    //SDL_RenderFillRect(renderer, &d_rect);
+    // move bullets down screen, and retire them if they are off screen or if they hit something.
+    int index = 0;
+    while (index < bullets.Size()){
+        Projectile &bullet = bullets.At(index);
+        bullet.Process(clock);
+        if (bullet.hit || bullet.y_pos >= screen_height){
+            projectile_count[bullet.owner]--;
+            bullets.Retire(index);
+        }
+        else {
+            index++;
+        }
+    }
 
-    if (!dead){
-        // Render the enemy ship if the enemy isn't dead.
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        sprites[state]->Render();
-    }  
-}
+    // the projectiles of the emitters all move in one pass, the ones that left the screen or hit something are gone.
+    field.Process(seconds, screen_width, screen_height);
+    cache->Advance(&field_playhead, 1, seconds);
 
-Enemy::~Enemy(){
-    for (auto const sprite: sprites){
-        delete sprite.second;
+    // if there is a cooldown, count down the cooldown until it reaches the limit, then disable the cooldown.
+    // this is done so that an enemy can only add a bullet in certain intervals.
+    for (int i = 0; i < active; i++){
+        if (attack_cooldown[i]){
+            cooldown_timer[i] += seconds;
+            if (cooldown_timer[i] >= cooldown_time[i]){
+                cooldown_timer[i] = 0;
+                attack_cooldown[i] = false;
+            }
+        }
     }
 
-    for (int i = 0; i < int(bullets.size()); i++){
-        delete bullets[i];
-        bullets.erase(bullets.begin() + i);
+    // the collision rect follows the simulated position, not the interpolated one that is rendered.
+    for (int i = 0; i < active; i++){
+        int grow = kind_grow[kind[i]][state[i]];
+        rects[i].x = (x[i] - int(rects[i].w / 2));
+        rects[i].y = (y[i] - int(rects[i].h / 2));
+        rects[i].w = width[i] + grow;
+        rects[i].h = height[i] + grow;
     }
 }
 
-Villian1::Villian1(SpriteCache * cache, int x, int y, int w, int h, string src, string t, Player * player)
-: Enemy(cache, x, y, w, h, src, t, player) {
-    SDL_Rect s_rect;
-    s_rect = {30, 24, 40, 40};
-    
-    sprites["DEFAULT"] = new Sprite(cache, s_rect, d_rect, "resources/villain1.bmp");
-    sprites["DYING"] = new AnimatedSprite(cache, {0, 0, 64, 64}, {d_rect.x, d_rect.y, d_rect.w + 60, d_rect.h + 60}, "resources/explosion.bmp", 64, 4, .1);
-    state = "DEFAULT";
-    projectile_speed = 3;
-    cooldown_time = .3;
-    max_projectiles = 2;
-
-}
-
-bool Villian1::Attack(){
-
-    float angle_to_player = 270;
-
-    if (state == "DEFAULT"){
-        if ((int(bullets.size()) < max_projectiles) && !attack_cooldown && canShoot()){
-            bullets.push_back(
-                new Blaster(cache, x_pos,
-                                    (y_pos + (d_rect.w/2)) - 20, 20, 20, angle_to_player, {255, 0, 0, 255}, projectile_speed)
-            );
-            attack_cooldown = true;
-            return true;
+void EnemyStore::Reset(){
+    // bring every enemy back into play at once: each one goes back to the place of its id, so the level starts
+    // with its enemies in the order they were added. Every swap puts one enemy where it belongs.
+    for (int k = 0; k < count; k++){
+        while (id[k] != k){
+            Swap(k, id[k]);
         }
     }
-    return false; 
-}
-
-Villian2::Villian2(SpriteCache * cache, int x, int y, int w, int h, string src, string t, Player * player): Enemy(cache,x,y,w,h,src,t,player){
-    SDL_Rect s_rect;
-    s_rect = {15, 15, 20, 20};
-    
-    sprites["DEFAULT"] = new Sprite(cache, s_rect, d_rect, "resources/villain2.bmp");
-    sprites["DYING"] = new AnimatedSprite(cache, {0, 0, 64, 64}, {d_rect.x, d_rect.y, d_rect.w + 60, d_rect.h + 60}, "resources/explosion.bmp", 64, 4, .1);
-    state = "DEFAULT";
-    projectile_speed = 3;
-    cooldown_time = .3;
-
+    active = count;
+    destroyed = 0;
+
+    for (int i = 0; i < count; i++){
+        cache->Rewind(&playheads[i]);
+        moving[i] = false;
+        attack_cooldown[i] = false;
+        cooldown_timer[i] = 0.0;
+        state[i] = enemy_transitions[state[i]][ENEMY_RESET];
+        SetPos(i, starting_x[i], starting_y[i]);
+        rects[i] = {starting_x[i], starting_y[i], width[i], height[i]};
+        parts[i] = Compound(i) ? hitboxes.AllParts(hitbox[i]) : 0;
+        emitter_timer[i] = 0.0;
+        int pattern = enemy_kinds[kind[i]].pattern;
+        emitter_heading[i] = pattern >= 0 ? DegreesToAngle(emitter_patterns[pattern].heading) : 0;
+        projectile_count[i] = 0;
+    }
+    bullets.Clear();
+    field.Clear();
+    cache->Rewind(&field_playhead);
 }
 
-bool Villian2::Attack(){
+void EnemyStore::Render(RenderSnapshot * snapshot){
+    // room for everything the enemies can draw, so a snapshot grows once and not as the field fills up.
+    snapshot->commands.reserve(snapshot->commands.size() + count + bullets.Capacity() + field.Capacity());
 
-    float angle_to_player = (-atan2((player->y_pos-y_pos), (player->x_pos-x_pos))) * (180 /PI);
+    // Render any bullets if they exist.
+    for (auto &bullet: bullets){
+        bullet.Render(snapshot);
+    }
+    for (int i = 0; i < field.count; i++){
+        int size = int(field.half[i] * 2);
+        cache->RenderClip(snapshot, field_clip, &field_playhead, size, size, field.x[i], field.y[i], field.last_x[i], field.last_y[i]);
+    }
 
-    if (state == "DEFAULT"){
-        if ((int(bullets.size()) < max_projectiles) && !attack_cooldown){
-            bullets.push_back(
-                new Laser2(cache, x_pos,
-                                (y_pos + (d_rect.w/2)) - 10, 15, 20, angle_to_player, {255, 0, 0, 255}, projectile_speed)
-            );
-            attack_cooldown = true;
-            return true;
-        }
+    // Render the enemy ships that are still in play, in between the last and current tick.
+    for (int i = 0; i < active; i++){
+        cache->RenderClip(snapshot, Clip(i), &playheads[i], width[i], height[i], x[i], y[i], last_x[i], last_y[i]);
     }
-    return false; 
-}
\ No newline at end of file
+}
@@ -3,58 +3,128 @@
 #include "sprites.h"
 #include "projectile.h"
 #include "player.h"
+#include "compound.h"
+#include "emitter.h"
 
-class Enemy{
-protected:
-    map<string, Sprite *> sprites;
-    int width, height;
-    bool moving;
-    string direction;
-    int starting_xpos, starting_ypos;
-    SDL_Renderer * renderer;
-    SpriteCache * cache; 
-
-public:
-    vector<int> erased;
-    string type;
-    string state;
-    SDL_Rect d_rect = {};
-    double x_pos, y_pos;
-    int projectile_speed = 0;
-    int default_speed = 0;
-    int speed = 0;
-    int max_projectiles = 1;
-    bool attack_cooldown;
-    double cooldown_timer = 0.0;
-    double cooldown_time = 0.0;
-    vector<Projectile *> bullets = {};
-    bool dead = false;
-    Player * player;
-
-    Enemy(SpriteCache * cache, int x, int y, int w, int h, string src, string t, Player * player);
-
-    virtual void Process(Clock * clock, int height);
-    virtual void Move(string d);
-    void SetPos(int x, int y);
-    void Reset();
-    bool canShoot();
-    virtual bool Attack();
-    bool TouchingBullet(SDL_Rect * rect);
-
-    virtual void Render();
-    virtual ~Enemy();
+enum EnemyKind {
+    VILLAIN1,
+    VILLAIN2,
+    // a boss built from parts that are shot off one at a time.
+    MOTHERSHIP,
+    ENEMY_KIND_COUNT
 };
 
-class Villian1: public Enemy{
-    public:
-        bool Attack();
-        Villian1(SpriteCache * cache, int x, int y, int w, int h, string src, string t, Player * player);
-
+// What sets the kinds of enemies apart, a level file names the kind of its enemies by name.
+struct EnemyKindInfo {
+    const char * name;
+    const char * sprite;
+    SDL_Rect s_rect;
+    int speed;
+    int projectile_speed;
+    int max_projectiles;
+    double cooldown_time;
+    // the emitter pattern it fires besides its projectiles, or -1.
+    int pattern;
+    // the parts of a kind that is hit part by part, in the pixels of s_rect, or none.
+    const HitboxPart * parts;
+    int part_count;
 };
 
+extern const EnemyKindInfo enemy_kinds[ENEMY_KIND_COUNT];
+
+// the kind with the given name, or ENEMY_KIND_COUNT when there is none.
+EnemyKind FindEnemyKind(string name);
+
+/*
+    All the enemies of a level, stored as parallel arrays: enemy i is at x[i], y[i], in state[i] and so on.
+    The level decides what each enemy does one at a time (who shoots, where the fleet goes, who got hit),
+    then Process updates all of them together, one array at a time, in loops the compiler can vectorize.
+    The flags are Uint8 instead of bool because vector<bool> packs them into bits.
+    The arrays are kept in the arena of the level.
+
+    The first active enemies are the ones still in play (alive or exploding), the dead ones are after them, so
+    every loop only goes over the ones in play. An enemy that dies swaps places with the last active one.
+    The place of an enemy changes, its id doesn't; Reset puts every enemy back in the place of its id.
+*/
+class EnemyStore {
+    private:
+        SpriteCache * cache;
+        // the clip of every state of every kind, and the clip of the projectiles of every kind.
+        int kind_clips[ENEMY_KIND_COUNT][ENEMY_STATE_COUNT] = {};
+        int projectile_clips[ENEMY_KIND_COUNT] = {};
+        // how much bigger than the enemy the clip of every state is drawn, and so how big its collision rect is.
+        int kind_grow[ENEMY_KIND_COUNT][ENEMY_STATE_COUNT] = {};
+        // all the projectiles of the field are drawn with the same clip, and animated together.
+        int field_clip = -1;
+        Playhead field_playhead;
+        // the compound hitboxes of the kinds that have parts, at every size they are drawn at.
+        CompoundHitboxes hitboxes;
+
+        void Swap(int a, int b);
+        void Deactivate(int i);
 
-class Villian2: public Enemy{
     public:
-        bool Attack();
-        Villian2(SpriteCache * cache, int x, int y, int w, int h, string src, string t, Player * player);
-};
\ No newline at end of file
+        Player * player = nullptr;
+        int count = 0;
+        int active = 0;
+        // enemies that were hit, whether their explosion is still playing or not.
+        int destroyed = 0;
+
+        ArenaVector<int> id;
+        // where the enemy with every id is now, so slot[id[i]] == i.
+        ArenaVector<int> slot;
+        ArenaVector<EnemyKind> kind;
+        ArenaVector<EnemyState> state;
+        ArenaVector<Uint8> moving;
+        ArenaVector<Direction> direction;
+        ArenaVector<double> x, y;
+        ArenaVector<double> last_x, last_y;
+        // worked out from the direction and speed at the start of every update.
+        ArenaVector<double> velocity_x, velocity_y;
+        ArenaVector<int> speed, default_speed;
+        ArenaVector<Uint8> attack_cooldown;
+        ArenaVector<double> cooldown_timer, cooldown_time;
+        // where every enemy is in the clip of its state.
+        ArenaVector<Playhead> playheads;
+        ArenaVector<SDL_Rect> rects;
+        // the collision masks of the clip every enemy plays while alive, drawn as big as its rect.
+        ArenaVector<int> masks;
+        // the compound hitbox of every enemy, or -1 when it is hit as a whole, and a bit for every part it still has.
+        ArenaVector<int> hitbox;
+        ArenaVector<Uint64> parts;
+        ArenaVector<int> width, height;
+        ArenaVector<int> starting_x, starting_y;
+        // how many of the projectiles in the pool every enemy fired, they can only have so many at once.
+        // this is by id, not by place, so it doesn't move when the enemies do.
+        ArenaVector<int> projectile_count;
+        // the projectiles of all the enemies, the owner of a projectile is the id of the enemy that fired it.
+        ProjectilePool bullets;
+        // the projectiles of the emitters of all the enemies, and when every enemy fires its next volley and which way.
+        ProjectileField field;
+        ArenaVector<double> emitter_timer;
+        ArenaVector<BinaryAngle> emitter_heading;
+
+        EnemyStore(Arena * arena, SpriteCache * cache);
+
+        int Add(EnemyKind kind, int x, int y, int w, int h);
+        int Clip(int i);
+        void Move(int i, Direction d);
+        void SetPos(int i, int x, int y);
+        bool CanShoot(int i);
+        bool Attack(int i);
+        void Hit(int i);
+        // whether rect touches the pixels of the enemy, an enemy that isn't alive is tested by its rect.
+        bool Touches(int i, const SDL_Rect &rect);
+        const CollisionMask & Mask(int i);
+        bool Compound(int i);
+        // sweeps the bullet against the parts the enemy still has, part is the one it reaches first.
+        bool SweepParts(int i, Projectile &bullet, double * time, int * part);
+        // shoots the part off, true when that destroys the enemy: it was a core part or the last one.
+        bool HitPart(int i, int part);
+        // fires a volley from the emitter of the enemy when one is due.
+        void Emit(int i, double seconds);
+
+        void Process(Clock * clock, int screen_width, int screen_height);
+        void Reset();
+        void Render(RenderSnapshot * snapshot);
+};
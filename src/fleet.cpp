@@ -0,0 +1,196 @@
+#include "fleet.h"
+#include <climits>
+
+Fleet::Fleet(Arena * arena)
+: cells(arena), column_starts(arena), cell_of(arena), column_of(arena), left(arena), right(arena), top(arena),
+  alive(arena), alive_columns(arena), column_alive(arena), column_left(arena), column_right(arena), shooters(arena) {}
+
+void Fleet::Add(int x, int y, int w, int speed){
+    // placed the way the enemies place their rects, around x.
+    left.push_back(x - int(w / 2));
+    right.push_back(x - int(w / 2) + w);
+    top.push_back(y);
+    base_speed = count ? min(base_speed, speed) : speed;
+    count++;
+    formed = false;
+}
+
+void Fleet::Form(){
+    vector<int> order(count);
+    for (int i = 0; i < count; i++){
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [&](int a, int b){
+        return left[a] != left[b] ? left[a] < left[b] : a < b;
+    });
+
+    // sweep from left to right, a column goes on for as long as the next enemy overlaps it.
+    column_starts.clear();
+    column_of.assign(count, 0);
+    int column_end = INT_MIN;
+    for (int k = 0; k < count; k++){
+        int id = order[k];
+        if (left[id] >= column_end){
+            column_starts.push_back(k);
+            column_end = right[id];
+        }
+        column_end = max(column_end, right[id]);
+        column_of[id] = int(column_starts.size()) - 1;
+    }
+    int columns = int(column_starts.size());
+    column_starts.push_back(count);
+
+    // the enemies of every column from the bottom up.
+    for (int c = 0; c < columns; c++){
+        sort(order.begin() + column_starts[c], order.begin() + column_starts[c + 1], [&](int a, int b){
+            return top[a] != top[b] ? top[a] > top[b] : a < b;
+        });
+    }
+    cells.assign(order.begin(), order.end());
+    cell_of.assign(count, 0);
+    for (int k = 0; k < count; k++){
+        cell_of[cells[k]] = k;
+    }
+
+    alive.assign((count + 63) / 64, 0);
+    alive_columns.assign((columns + 63) / 64, 0);
+    column_alive.assign(columns, 0);
+    column_left.assign(columns, 0);
+    column_right.assign(columns, 0);
+    shooters.reserve(columns);
+    formed = true;
+}
+
+void Fleet::Reset(){
+    if (!formed){
+        Form();
+    }
+    int columns = int(column_alive.size());
+    for (int k = 0; k < count; k++){
+        alive[k / 64] |= Uint64(1) << (k % 64);
+    }
+    for (int c = 0; c < columns; c++){
+        alive_columns[c / 64] |= Uint64(1) << (c % 64);
+        column_alive[c] = column_starts[c + 1] - column_starts[c];
+        Bounds(c);
+    }
+    killed = 0;
+    speed = base_speed;
+    offset_x = 0.0;
+}
+
+// the edges of the alive enemies of a column, only needed again when one at an edge dies.
+void Fleet::Bounds(int column){
+    int low = INT_MAX, high = INT_MIN;
+    for (int k = column_starts[column]; k < column_starts[column + 1]; k++){
+        if (alive[k / 64] >> (k % 64) & 1){
+            low = min(low, left[cells[k]]);
+            high = max(high, right[cells[k]]);
+        }
+    }
+    column_left[column] = low;
+    column_right[column] = high;
+}
+
+void Fleet::Kill(int id){
+    int k = cell_of[id];
+    if (!(alive[k / 64] >> (k % 64) & 1)){
+        return;
+    }
+    alive[k / 64] &= ~(Uint64(1) << (k % 64));
+    int c = column_of[id];
+    if (--column_alive[c] == 0){
+        alive_columns[c / 64] &= ~(Uint64(1) << (c % 64));
+    }
+    else if (left[id] == column_left[c] || right[id] == column_right[c]){
+        Bounds(c);
+    }
+
+    // the same speed up the enemies always had, 12 more at the last one.
+    killed++;
+    speed = base_speed + (count > 1 ? int(double(killed) / double(count - 1) * 12) : 0);
+}
+
+int Fleet::Alive(){
+    return count - killed;
+}
+
+int Fleet::FirstAlive(int first, int last){
+    for (int k = first; k < last; k = (k / 64 + 1) * 64){
+        Uint64 bits = alive[k / 64] >> (k % 64);
+        if (bits){
+            k += __builtin_ctzll(bits);
+            return k < last ? k : -1;
+        }
+    }
+    return -1;
+}
+
+double Fleet::Left(){
+    for (int w = 0; w < int(alive_columns.size()); w++){
+        if (alive_columns[w]){
+            return column_left[w * 64 + __builtin_ctzll(alive_columns[w])] + offset_x;
+        }
+    }
+    return 0.0;
+}
+
+double Fleet::Right(){
+    for (int w = int(alive_columns.size()) - 1; w >= 0; w--){
+        if (alive_columns[w]){
+            return column_right[w * 64 + 63 - __builtin_clzll(alive_columns[w])] + offset_x;
+        }
+    }
+    return 0.0;
+}
+
+Direction Fleet::March(int width, double seconds){
+    if (!Alive()){
+        return DIRECTION_NONE;
+    }
+    if (phase == PHASE_LEFT && Left() <= 0){
+        phase = fleet_transitions[phase][FLEET_EDGE_REACHED];
+    }
+    else if (phase == PHASE_RIGHT && Right() >= width){
+        phase = fleet_transitions[phase][FLEET_EDGE_REACHED];
+    }
+
+    Direction heading = fleet_directions[phase];
+    if (heading == DIRECTION_DOWN){
+        drop_time += seconds;
+        // this tick still goes down, the next one goes sideways.
+        if (drop_time >= .2){
+            phase = fleet_transitions[phase][FLEET_DROPPED];
+            drop_time = 0.0;
+        }
+    }
+    return heading;
+}
+
+void Fleet::Advance(Direction heading, double seconds){
+    // the same step the enemies take, so the offset stays where they are.
+    double step = speed * 10;
+    if (heading == DIRECTION_LEFT){
+        offset_x += -step * seconds;
+    }
+    else if (heading == DIRECTION_RIGHT){
+        offset_x += step * seconds;
+    }
+}
+
+int Fleet::PickShooter(mt19937 &rng){
+    shooters.clear();
+    for (int w = 0; w < int(alive_columns.size()); w++){
+        for (Uint64 bits = alive_columns[w]; bits; bits &= bits - 1){
+            int c = w * 64 + __builtin_ctzll(bits);
+            int k = FirstAlive(column_starts[c], column_starts[c + 1]);
+            if (k >= 0){
+                shooters.push_back(cells[k]);
+            }
+        }
+    }
+    if (shooters.empty()){
+        return -1;
+    }
+    return shooters[rng() % shooters.size()];
+}
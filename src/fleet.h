@@ -0,0 +1,73 @@
+#pragma once
+#include "headers.h"
+#include "arena.h"
+#include "states.h"
+
+/*
+    The invaders of a level marching as one formation. Every enemy that is still alive moves the same way at the same
+    speed, so where the fleet is comes down to one offset from where the enemies started, and the march only has to
+    look at the fleet instead of every enemy.
+
+    The enemies are put into columns once, by where they start: sorted by their left edge, an enemy joins the column
+    before it when it overlaps it, otherwise it starts a new one. Within a column the enemies go from the bottom up.
+    Every cell of the formation has a bit that says whether its enemy is alive, and every column has a bit that says
+    whether any of its enemies is. The edges of the fleet are the edges of the first and last alive columns, which
+    are kept up to date as enemies die, so they are found with a couple of bit scans. The enemy that shoots is the
+    bottom-most alive one of a column, found from the bits of the column.
+
+    The fleet moves at the speed of its slowest kind, and gets faster with every enemy killed.
+*/
+class Fleet {
+    private:
+        int count = 0;
+        bool formed = false;
+        int base_speed = 0;
+        int killed = 0;
+
+        // the id of the enemy of every cell, column c is cells[column_starts[c]] up to cells[column_starts[c + 1]].
+        ArenaVector<int> cells;
+        ArenaVector<int> column_starts;
+        // the cell and the column of every enemy id.
+        ArenaVector<int> cell_of, column_of;
+        // the left and right edge every enemy starts at, and how far down, by id.
+        ArenaVector<int> left, right, top;
+        // a bit for every cell and for every column.
+        ArenaVector<Uint64> alive;
+        ArenaVector<Uint64> alive_columns;
+        // how many enemies of every column are alive, and the edges of the alive ones where they started.
+        ArenaVector<int> column_alive;
+        ArenaVector<int> column_left, column_right;
+        // the bottom-most alive enemy of every column, when a shooter is picked.
+        ArenaVector<int> shooters;
+
+        void Form();
+        void Bounds(int column);
+        // the first alive cell from first up to last (not included), or -1.
+        int FirstAlive(int first, int last);
+
+    public:
+        FleetPhase phase = PHASE_LEFT;
+        // how long the fleet has been going down.
+        double drop_time = 0.0;
+        // how far the fleet moved along x since the enemies were put in place.
+        double offset_x = 0.0;
+        int speed = 0;
+
+        Fleet(Arena * arena);
+
+        // the enemies are added in the order of their ids.
+        void Add(int x, int y, int w, int speed);
+        // every enemy alive and back in place, the phase of the march is kept.
+        void Reset();
+        void Kill(int id);
+        int Alive();
+        // where the left and right edges of the alive enemies are now.
+        double Left();
+        double Right();
+
+        // which way the fleet goes this tick, it turns when it reaches an edge of the screen.
+        Direction March(int width, double seconds);
+        void Advance(Direction heading, double seconds);
+        // the id of the enemy that shoots, one of the bottom-most alive enemies of the columns, or -1.
+        int PickShooter(mt19937 &rng);
+};
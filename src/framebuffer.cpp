@@ -2,7 +2,7 @@
 
 Framebuffer::Framebuffer(SDL_Window * window, SDL_Renderer * target) {
     renderer = target;
-    pixel_format = SDL_GetWindowPixelFormat(window);
+    pixel_format = window ? SDL_GetWindowPixelFormat(window) : 0;
 }
 
 Framebuffer::~Framebuffer(){
@@ -1,4 +1,7 @@
 #include "functions.h"
+#include "trace.h"
+#include <climits>
+#include <cerrno>
 
 void ShowError(char * title, string message, string log, bool show_sdl_error){
         string error_string = "";
@@ -20,52 +23,83 @@ vector<string> split(string const & word, char delim){
     return strings;
 }
 
-LevelScene * CreateScene(SpriteCache * cache,Framebuffer * framebuffer, TextCache * text_cache,Player * player, string filepath, SDL_RendererFlip * flip){
-    LevelScene * scene = new LevelScene(cache->renderer,framebuffer ,cache, text_cache,flip);
+bool ParseInteger(string const & text, long long min, long long max, long long * value){
+    if (text.empty()){
+        return false;
+    }
+    char * end = nullptr;
+    errno = 0;
+    long long number = strtoll(text.c_str(), &end, 10);
+    if (errno == ERANGE || *end != '\0' || end == text.c_str() || number < min || number > max){
+        return false;
+    }
+    *value = number;
+    return true;
+}
+
+LevelScene * CreateScene(SpriteCache * cache, Player * player, string filepath, SDL_RendererFlip * flip){
+    TRACE_INSTANT("scene built", filepath.c_str());
     ifstream level_file(filepath.c_str());
+    if (!level_file.is_open()){
+        SDL_Log("Couldn't open level %s", filepath.c_str());
+        return nullptr;
+    }
+
+    LevelScene * scene = new LevelScene(cache, flip);
+    // a line the level can't be read from leaves nothing of it behind.
+    auto reject = [&](string reason){
+        SDL_Log("Couldn't load level %s: %s", filepath.c_str(), reason.c_str());
+        delete scene;
+        return nullptr;
+    };
+
     string line;
     string obj_name;
     string obj_filepath;
-    if (level_file.is_open()){
-        while (getline(level_file, line)){
+    bool has_player = false;
+    while (getline(level_file, line)){
 
-            vector<string> section = split(line, '|');
+        vector<string> section = split(line, '|');
+        if (section.empty()){
+            continue;
+        }
 
-            if (section[0] == "*"){
-                vector<string> subsect = split(section[1], ':');
-                obj_name = subsect[0];
-                obj_filepath = subsect[1];
+        if (section[0] == "*"){
+            vector<string> subsect = section.size() < 2 ? vector<string>() : split(section[1], ':');
+            if (subsect.size() < 2){
+                return reject("an object without a name and a sprite: " + line);
             }
-            else if (section[0] == "+"){
-                vector<string> obj_info_list = split(section[1], ',');
-                for (auto obj_info: obj_info_list){
-                    vector<string> obj_xywh = split(obj_info, '-');
-                    if (obj_xywh.size() < 4){}
-                    else {
-                        int x = stoi(obj_xywh[0]);
-                        int y = stoi(obj_xywh[1]);
-                        int w = stoi(obj_xywh[2]);
-                        int h = stoi(obj_xywh[3]);
-
-                        if (obj_name == "player"){
-                            player->Reset();
-                            player->SetPos(x, y);
-                            player->d_rect.w = w;
-                            player->d_rect.h = h;
+            obj_name = subsect[0];
+            obj_filepath = subsect[1];
+        }
+        else if (section[0] == "+"){
+            if (section.size() < 2){
+                return reject("a line without rects: " + line);
+            }
+            vector<string> obj_info_list = split(section[1], ',');
+            for (auto obj_info: obj_info_list){
+                vector<string> obj_xywh = split(obj_info, '-');
+                long long x, y, w, h;
+                if (obj_xywh.size() != 4 || !ParseInteger(obj_xywh[0], INT_MIN, INT_MAX, &x) || !ParseInteger(obj_xywh[1], INT_MIN, INT_MAX, &y)
+                    || !ParseInteger(obj_xywh[2], 1, INT_MAX, &w) || !ParseInteger(obj_xywh[3], 1, INT_MAX, &h)){
+                    return reject("a rect that isn't x-y-w-h: " + obj_info);
+                }
 
-                            scene->AddPlayer(player);
-                        }
-                        else if (obj_name == "villain1"){
-                            scene->AddEnemy(new Villian1(cache, x, y, w, h, obj_filepath, "villain1",player));
-                        }
-                        else if (obj_name == "villain2"){
-                            scene->AddEnemy(new Villian2(cache, x, y, w, h, obj_filepath, "villain2",player));
-                        }
-                    }
+                // the player is only put in place when the level starts, see LevelScene::Restart.
+                if (obj_name == "player"){
+                    scene->AddPlayer(player, int(x), int(y), int(w), int(h));
+                    has_player = true;
+                }
+                else if (FindEnemyKind(obj_name) != ENEMY_KIND_COUNT){
+                    scene->AddEnemy(FindEnemyKind(obj_name), int(x), int(y), int(w), int(h));
                 }
             }
         }
-        level_file.close();
+    }
+    level_file.close();
+
+    if (!has_player){
+        return reject("no player");
     }
     return scene;
-}
\ No newline at end of file
+}
@@ -8,4 +8,9 @@ void ShowError(char * title, string message, string log, bool show_sdl_error);
 
 vector<string> split(string const & word, char delim = ' ');
 
-LevelScene * CreateScene(SpriteCache * cache, Framebuffer * framebuffer , TextCache * ,Player * player, string filepath,SDL_RendererFlip * flip);
\ No newline at end of file
+// reads a whole number from the level and replay files, false if text is anything but a number from min to max.
+bool ParseInteger(string const & text, long long min, long long max, long long * value);
+
+// the level built from the level file, or nullptr (with the reason logged) if the file can't be read or has no player.
+
+LevelScene * CreateScene(SpriteCache * cache, Player * player, string filepath, SDL_RendererFlip * flip);
\ No newline at end of file
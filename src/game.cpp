@@ -4,7 +4,85 @@ SpaceInversion::SpaceInversion(){};
 
 int SpaceInversion::Start(int argc, char** argv){
     // Process command line arguments if needed.
-        // ...
+    for (int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if (arg == "--fps" && i + 1 < argc){
+            pacer.SetTargetRate(atof(argv[++i]));
+        }
+        else if (arg == "--uncapped"){
+            pacer.SetTargetRate(0);
+        }
+        else if (arg == "--no-vsync"){
+            RENDERER_FLAGS &= ~SDL_RENDERER_PRESENTVSYNC;
+            pacer.vsync = false;
+        }
+        else if (arg == "--headless"){
+            headless = true;
+        }
+        else if (arg == "--level" && i + 1 < argc){
+            headless_level = argv[++i];
+        }
+        else if (arg == "--ticks" && i + 1 < argc){
+            headless_ticks = atol(argv[++i]);
+        }
+        else if (arg == "--check-allocations"){
+            check_allocations = true;
+        }
+        else if (arg == "--seed" && i + 1 < argc){
+            seed = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--record" && i + 1 < argc){
+            record_path = argv[++i];
+        }
+        else if (arg == "--single-thread"){
+            threaded = false;
+        }
+        else if (arg == "--replay" && i + 1 < argc){
+            replay_path = argv[++i];
+            headless = true;
+        }
+        else if (arg == "--trace" && i + 1 < argc){
+            trace_path = argv[++i];
+            trace_on_start = true;
+        }
+        else if (arg == "--trace-seconds" && i + 1 < argc){
+            trace_seconds = atof(argv[++i]);
+        }
+    }
+
+    #ifndef SPACE_INVERSION_PROFILING
+    if (trace_on_start){
+        cout << "Tracing needs a build with SPACE_INVERSION_PROFILING defined, no trace will be written." << endl;
+    }
+    #endif
+
+    // In headless mode no video or audio device is opened, the level is simulated as fast as possible.
+    if (headless){
+        SDL_Init(0);
+        atexit(SDL_Quit);
+
+        // a replay brings its own level, seed and tick rate.
+        if (replay_path != ""){
+            playback = new Replay();
+            if (!playback->Load(replay_path)){
+                cout << "Couldn't load replay " << replay_path << endl;
+                return 0;
+            }
+            headless_level = playback->level_path;
+            headless_ticks = playback->inputs.size();
+            seed = playback->seed;
+            tick_rate = playback->tick_rate;
+        }
+
+        simulation = new Simulation(headless_level, tick_rate, seed);
+        if (!simulation->Loaded()){
+            cout << "Couldn't load level " << headless_level << endl;
+            return 0;
+        }
+        running = true;
+        return 1;
+    }
+
     // Initialize SDL2
     SDL_Init(SDL_INIT_VIDEO|SDL_INIT_AUDIO|SDL_INIT_GAMECONTROLLER);
     Mix_Init(MIX_INIT_MOD);
@@ -31,7 +109,13 @@ int SpaceInversion::Start(int argc, char** argv){
     }
 
     // Initialize random seed
-    srand(time(NULL));
+    srand(seed);
+
+    // The pacer needs the refresh rate to tell when a vsync interval was missed.
+    SDL_DisplayMode mode;
+    if (SDL_GetWindowDisplayMode(window, &mode) == 0){
+        pacer.SetRefreshRate(mode.refresh_rate);
+    }
 
     // Load window icon
     SDL_Surface * icon = SDL_LoadBMP("resources/icon.bmp");
@@ -43,24 +127,33 @@ int SpaceInversion::Start(int argc, char** argv){
 
     // Start clock
     clock = Clock();
+    sim_clock = Clock();
+    sim_clock.SetDelta(1.0 / tick_rate);
 
     // Initialize objects
     jukebox = new Jukebox();
     mouse = new MouseManager();
+    sim_mouse = new MouseManager();
     keyboard = new KeyboardManager();
     controllers = new ControllerManager();
     framebuffer = new Framebuffer(window, renderer);
     text = new TextCache(renderer);
     cache = new SpriteCache(renderer);
+    // every texture is created up front, since the levels are built on the simulation thread.
+    cache->Preload();
     p1 = new Player(cache, 640, 600, 50, 50, "resources/player.bmp");
 
     text->SetFont("joystix.ttf");
 
-    menu = new MenuScene(cache, framebuffer, text, &flip, p1);
+    menu = new MenuScene(cache, &flip, p1);
     game_scene = nullptr;
+    scenes = new SceneCache(cache, p1, &flip);
     framebuffer->CreateBuffer("MENU", WIDTH, HEIGHT);
     framebuffer->CreateBuffer("GAME", GAME_WIDTH, GAME_HEIGHT);
     framebuffer->CreateBuffer("HUD", GAME_WIDTH, HEIGHT);
+
+    // so there is something to draw before the first tick.
+    PublishSnapshot();
     
     // Start running the app
     running = true;
@@ -69,30 +162,202 @@ int SpaceInversion::Start(int argc, char** argv){
 
 
 void SpaceInversion::Loop(){
+    if (headless){
+        RunHeadless();
+        return;
+    }
+
     #ifndef __EMSCRIPTEN__
+    if (threaded){
+        tracer.SetThreadName("main");
+        if (trace_on_start){
+            StartTrace();
+            trace_on_start = false;
+        }
+        sim_thread = thread(&SpaceInversion::SimulationLoop, this);
+        while (running){
+            clock.Tick();
+            #ifdef SPACE_INVERSION_PROFILING
+            profiler.EndFrame(clock.delta_time);
+            #endif
+            PollEvents();
+            PostInput();
+            Render();
+            pacer.Wait();
+        }
+        sim_thread.join();
+        return;
+    }
+
+    tracer.SetThreadName("main");
     while (running) {
     #endif
 
-        Process();
+        if (trace_on_start){
+            StartTrace();
+            trace_on_start = false;
+        }
+
+        // Clock tick
+        clock.Tick();
+        #ifdef SPACE_INVERSION_PROFILING
+        profiler.EndFrame(clock.delta_time);
+        #endif
+        PollEvents();
+        PostInput();
+
+        /*
+            The simulation runs at a fixed rate, the time of the last frame is put into the accumulator
+            and as many ticks as fit into it are processed. The leftover time is used to interpolate
+            the positions between the previous and the current tick when rendering. The accumulator
+            is capped so a long hitch doesn't make the game try to catch up forever.
+        */
+        double step = sim_clock.delta_time_s;
+        accumulator += clock.delta_time_s;
+        if (accumulator > step * max_ticks_per_frame){
+            accumulator = step * max_ticks_per_frame;
+        }
+
+        bool ticked = false;
+        while (accumulator >= step && running){
+            Process();
+            accumulator -= step;
+            ticked = true;
+            total_ticks++;
+        }
+        if (ticked){
+            PublishSnapshot();
+        }
+        alpha = accumulator / step;
+
         Render();
-        SDL_Delay(5);
+        total_frames++;
+
+        // In the browser the frames are scheduled for us.
+        #ifndef __EMSCRIPTEN__
+        pacer.Wait();
+        #endif
 
     #ifndef __EMSCRIPTEN__
     }
     #endif
 }
 
-void SpaceInversion::Process(){
-    // Clock tick
-    clock.Tick();
+void SpaceInversion::SimulationLoop(){
+    // Same fixed timestep as the single threaded loop, but the simulation sleeps until its next tick is due
+    // instead of waiting on the frame.
+    tracer.SetThreadName("simulation");
+    Clock tick_clock;
+    double tick_accumulator = 0.0;
+    double step = sim_clock.delta_time_s;
 
-    // Keyboard and Mouse
-    keyboard->Process();
-    mouse->Process();
-    if (keyboard->KeyIsPressed(SDL_SCANCODE_ESCAPE)){
-        running = false;
-    } 
+    while (running){
+        tick_clock.Tick();
+        tick_accumulator += tick_clock.delta_time_s;
+        if (tick_accumulator > step * max_ticks_per_frame){
+            tick_accumulator = step * max_ticks_per_frame;
+        }
+
+        bool ticked = false;
+        while (tick_accumulator >= step && running){
+            Process();
+            tick_accumulator -= step;
+            ticked = true;
+        }
+        if (ticked){
+            PublishSnapshot();
+        }
+
+        SDL_Delay(Uint32((step - tick_accumulator) * 1000));
+    }
+}
+
+void SpaceInversion::RunHeadless(){
+    // Without a replay there is no one to play, so the player stands still. The level keeps running until it ends
+    // or the tick limit is hit.
+    PlayerInput input;
+    tracer.SetThreadName("headless");
+    if (trace_on_start){
+        StartTrace();
+    }
+
+    // When checking allocations every tick is also recorded into a snapshot like in game. The first two seconds
+    // fill the pools and buffers of the level, after that nothing should be allocated anymore.
+    RenderSnapshot snapshot;
+    long warmup_ticks = long(tick_rate * 2);
+    AllocationStats steady;
+    bool steady_reached = false;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    while (running && simulation->ticks < headless_ticks && !simulation->Finished()){
+        if (simulation->ticks == warmup_ticks){
+            steady = Allocations::Totals();
+            steady_reached = true;
+        }
+        if (playback){
+            input = playback->GetInput(simulation->ticks);
+        }
+        simulation->Tick(&input);
+        if (check_allocations){
+            simulation->Render(&snapshot);
+        }
+    }
+    double seconds = double(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    AllocationStats allocations = Allocations::Totals();
+    StopTrace();
+
+    cout << "Headless run of " << headless_level << " (seed " << seed << "): " << simulation->ticks << " ticks in "
+         << seconds << "s (" << (seconds > 0 ? simulation->ticks / seconds : 0) << " ticks/s), score "
+         << simulation->Score() << ", lives " << simulation->Lives() << ", state hash " << hex << simulation->StateHash() << dec << endl;
+
+    if (check_allocations){
+        if (!Allocations::Tracking()){
+            cout << "Checking allocations needs a build with SPACE_INVERSION_TRACK_ALLOCATIONS defined." << endl;
+            exit_code = 1;
+        }
+        else if (!steady_reached){
+            cout << "The run ended within the first " << warmup_ticks << " ticks, there was nothing to check." << endl;
+            exit_code = 1;
+        }
+        else {
+            Uint64 count = allocations.allocations - steady.allocations;
+            cout << count << " allocations (" << allocations.bytes - steady.bytes << " bytes) in the "
+                 << simulation->ticks - warmup_ticks << " ticks after the first " << warmup_ticks << ": "
+                 << (count ? "FAILED" : "PASSED") << endl;
+            exit_code = count ? 1 : 0;
+        }
+    }
+    running = false;
+}
+
+void SpaceInversion::SaveRecording(){
+    if (recording){
+        recording->Save(record_path);
+        delete recording;
+        recording = nullptr;
+    }
+}
 
+void SpaceInversion::StartTrace(){
+    #ifdef SPACE_INVERSION_PROFILING
+    tracer.Start();
+    SDL_Log("Tracing to %s", trace_path.c_str());
+    #endif
+}
+
+void SpaceInversion::StopTrace(){
+    if (tracer.recording){
+        if (tracer.Stop(trace_path)){
+            SDL_Log("Wrote trace to %s", trace_path.c_str());
+        }
+        else {
+            SDL_Log("Couldn't write trace to %s", trace_path.c_str());
+        }
+    }
+}
+
+void SpaceInversion::PollEvents(){
+    PROFILE_ZONE("SDL_PollEvent");
     // Event Loop
     while (SDL_PollEvent(&event)){ 
         mouse->GetPositionEvent(&event);
@@ -102,10 +367,43 @@ void SpaceInversion::Process(){
             break;
         }
     }
+}
 
-    // General game loop stuff goes here 
+void SpaceInversion::PostInput(){
+    // Keyboard, Mouse and controllers are sampled once per frame and handed to the simulation.
+    keyboard->Process();
+    mouse->Process();
+    if (keyboard->KeyIsPressed(SDL_SCANCODE_ESCAPE)){
+        running = false;
+    } 
+    #ifdef SPACE_INVERSION_PROFILING
+    if (keyboard->KeyWasPressed(SDL_SCANCODE_F3)){
+        profiler.visible = !profiler.visible;
+    }
+    // a capture stops by itself after a few seconds, or on a second press.
+    if (keyboard->KeyWasPressed(SDL_SCANCODE_F4)){
+        if (tracer.recording){
+            StopTrace();
+        }
+        else {
+            StartTrace();
+        }
+    }
+    if (tracer.recording && tracer.Elapsed() >= trace_seconds){
+        StopTrace();
+    }
+    #endif
     controllers->ProcessControllerButtonState();
 
+    PlayerInput input = SampleInput(keyboard, controllers);
+    input_mailbox.Post(&input, mouse);
+}
+
+void SpaceInversion::Process(){
+    // Take the input that was posted since the last tick, a press only shows up in one tick.
+    PlayerInput input;
+    input_mailbox.Take(&input, sim_mouse);
+
     // Only for debug
     // if (keyboard->KeyWasPressed(SDL_SCANCODE_F)){
     //     if (flip == SDL_FLIP_NONE){
@@ -116,49 +414,144 @@ void SpaceInversion::Process(){
     //     }
     // }
 
-    if (state == "MENU"){
-        if (menu->Process(&clock, mouse, jukebox, &state, &scene_path)){
-            delete game_scene;
-            game_scene = CreateScene(cache, framebuffer, text, p1, scene_path, &flip);
+    if (state == GAME_MENU){
+        if (menu->Process(&sim_clock, sim_mouse, jukebox, &state, &scene_path)){
+            game_scene = scenes->Get(scene_path, jukebox);
+            // a level that can't be loaded leaves the game in the menu.
+            if (!game_scene){
+                SDL_Log("Couldn't load level %s", scene_path.c_str());
+                state = game_transitions[state][GAME_LEVEL_LEFT];
+                jukebox->PlayMusic("title_theme");
+                return;
+            }
+
+            // every level gets its own seed, so a recording of it can be played back without the rest of the session.
+            unsigned int level_seed = rand();
+            game_scene->Seed(level_seed);
+            if (record_path != ""){
+                SaveRecording();
+                recording = new Replay(scene_path, level_seed, tick_rate);
+            }
+        }
+        // while the level buttons are up the levels are built ahead of time, so entering one takes no time.
+        else if (menu->ShowingLevels()){
+            scenes->Prebuild(menu->LevelPaths());
         }
     }
     
-    if (state == "GAME") {
-        game_scene->Process(&clock, keyboard, mouse, controllers, jukebox, &state, GAME_WIDTH, GAME_HEIGHT);
+    if (state == GAME_LEVEL) {
+        if (recording){
+            recording->Record(&input);
+        }
+        game_scene->Process(&sim_clock, &input, controllers, jukebox, &state, GAME_WIDTH, GAME_HEIGHT);
+
+        if (state != GAME_LEVEL){
+            TRACE_INSTANT("scene", "MENU");
+            SaveRecording();
+        }
 
     }
     
 }
 
+void SpaceInversion::PublishSnapshot(){
+    // Record what the scenes look like after the last tick, and hand it to the render thread.
+    RenderSnapshot * snapshot = snapshots.Back();
+    snapshot->Clear();
+    snapshot->state = state;
+    snapshot->flip = flip;
+
+    if (state == GAME_MENU){
+        menu->RenderScene(snapshot);
+    }
+    if (state == GAME_LEVEL){
+        game_scene->RenderScene(snapshot);
+    }
+
+    snapshot->time = SDL_GetPerformanceCounter();
+    snapshots.Publish();
+}
+
 void SpaceInversion::Render(){
     if (running){
+        RenderSnapshot * snapshot = snapshots.Front();
+
+        // When the simulation has its own thread, the snapshot is drawn at the point in between the last two ticks
+        // given by how long ago the snapshot was published.
+        double frame_alpha = alpha;
+        if (threaded){
+            double since_tick = double(SDL_GetPerformanceCounter() - snapshot->time) / SDL_GetPerformanceFrequency();
+            frame_alpha = min(max(since_tick / sim_clock.delta_time_s, 0.0), 1.0);
+        }
+
         // Render scale
         SDL_RenderSetLogicalSize(renderer, WIDTH, HEIGHT);
 
-        if (state == "MENU"){
-            menu->RenderScene();
-        }
-        if (state == "GAME"){
-            game_scene->RenderScene();
-        }
+        snapshot->Draw(framebuffer, text, frame_alpha);
         
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
         SDL_RenderClear(renderer);
 
-        if (state == "MENU"){
+        if (snapshot->state == GAME_MENU){
             framebuffer->RenderBuffer("MENU", WIDTH/2, HEIGHT/2, WIDTH, HEIGHT);
         }
-        if (state == "GAME"){
+        if (snapshot->state == GAME_LEVEL){
             framebuffer->RenderBuffer("HUD",WIDTH/2, HEIGHT/2, GAME_WIDTH, HEIGHT);
-            framebuffer->RenderBuffer("GAME", WIDTH/2, HEIGHT/2, GAME_WIDTH, GAME_HEIGHT, flip);
+            framebuffer->RenderBuffer("GAME", WIDTH/2, HEIGHT/2, GAME_WIDTH, GAME_HEIGHT, snapshot->flip);
         }
 
-        SDL_RenderPresent(renderer);
+        #ifdef SPACE_INVERSION_PROFILING
+        profiler.Render(renderer, text, 10, 10);
+        #endif
+
+        {
+            PROFILE_ZONE("SDL_RenderPresent");
+            SDL_RenderPresent(renderer);
+        }
+        pacer.EndPresent();
     }
 }
 
+string SpaceInversion::FrameReport(){
+    /*
+        Frame timing as JSON. In the browser the frames are scheduled by requestAnimationFrame, so the typical
+        frame time tells the refresh rate of the display, and a frame that took more than one and a half of
+        those missed a refresh.
+    */
+    FrameStats stats = clock.GetFrameStats();
+    double refresh_hz = stats.p50 > 0 ? 1000.0 / stats.p50 : 0.0;
+    int missed = clock.CountFramesOver(stats.p50 * 1.5);
+    double ticks_per_frame = total_frames ? double(total_ticks) / total_frames : 0.0;
+
+    ArenaStats arenas = Arena::Totals();
+
+    char report[640];
+    snprintf(report, sizeof(report),
+            "{\"frames\":%d,\"min_ms\":%.3f,\"avg_ms\":%.3f,\"p50_ms\":%.3f,\"p95_ms\":%.3f,\"p99_ms\":%.3f,\"max_ms\":%.3f,"
+            "\"refresh_hz\":%.1f,\"missed_frames\":%d,\"tick_rate\":%.1f,\"ticks_per_frame\":%.3f,"
+            "\"arena_used_kb\":%.1f,\"arena_capacity_kb\":%.1f,\"arena_blocks\":%d}",
+            stats.frames, stats.min, stats.avg, stats.p50, stats.p95, stats.p99, stats.max,
+            refresh_hz, missed, tick_rate, ticks_per_frame,
+            arenas.used / 1024.0, arenas.capacity / 1024.0, arenas.blocks);
+    return report;
+}
+
 SpaceInversion::~SpaceInversion(){
-    delete game_scene;
+    SaveRecording();
+    StopTrace();
+    delete playback;
+    delete simulation;
+
+    // Report the frame pacing of the session.
+    if (!headless){
+        FrameStats stats = clock.GetFrameStats();
+        SDL_Log("Frame times over the last %d frames (ms): min %.3f avg %.3f p50 %.3f p95 %.3f p99 %.3f max %.3f",
+                stats.frames, stats.min, stats.avg, stats.p50, stats.p95, stats.p99, stats.max);
+        SDL_Log("Presented %d frames, %d dropped (missed vsync), %d late (missed the pacer deadline)",
+                pacer.presented_frames, pacer.dropped_frames, pacer.late_frames);
+    }
+
+    delete scenes;
     delete menu;
     delete p1;
     delete cache;
@@ -167,6 +560,7 @@ SpaceInversion::~SpaceInversion(){
     delete controllers;
     delete jukebox;
     delete mouse;
+    delete sim_mouse;
     delete keyboard;
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -2,15 +2,23 @@
 #include "headers.h"
 #include "functions.h"
 #include "framebuffer.h"
+#include "pacer.h"
+#include "profiler.h"
+#include "trace.h"
+#include "simulation.h"
+#include "replay.h"
+#include "snapshot.h"
+#include "triplebuffer.h"
 #include "scene.h"
+#include "scene_cache.h"
 
 
 class SpaceInversion {
 private:
 
     // Private SDL variables
-    SDL_Window * window;
-    SDL_Renderer * renderer;
+    SDL_Window * window = nullptr;
+    SDL_Renderer * renderer = nullptr;
     SDL_Event event;
 
     // Private general variables
@@ -18,30 +26,87 @@ private:
     int GAME_WIDTH = 800, GAME_HEIGHT = 600;
     Uint32 WINDOW_FLAGS = SDL_WINDOW_SHOWN;
     Uint32 RENDERER_FLAGS = SDL_RENDERER_PRESENTVSYNC;
-    string state = "MENU";
+    GameState state = GAME_MENU;
     SDL_RendererFlip flip = SDL_FLIP_NONE;
     string scene_path = "";
 
+    // Fixed timestep variables, the simulation always advances in steps of 1/tick_rate seconds.
+    double tick_rate = 120.0;
+    double accumulator = 0.0;
+    double alpha = 1.0;
+    int max_ticks_per_frame = 8;
+    // totals for the frame report, ticks processed by the single threaded loop and frames it rendered.
+    long total_ticks = 0;
+    long total_frames = 0;
+
+    /*
+        The simulation runs on its own thread and publishes a snapshot of what to draw after its ticks.
+        The main thread polls the input, hands it over through the mailbox and draws the newest snapshot,
+        so a slow present never holds up the simulation. The browser has no threads, so both run on one there.
+    */
+    #ifdef __EMSCRIPTEN__
+    bool threaded = false;
+    #else
+    bool threaded = true;
+    #endif
+    thread sim_thread;
+    TripleBuffer<RenderSnapshot> snapshots;
+    InputMailbox input_mailbox;
+
+    // Headless mode variables, a level is simulated without a window, renderer or audio.
+    bool headless = false;
+    string headless_level = "resources/levels/level.mx";
+    long headless_ticks = 120 * 60;
+    unsigned int seed = time(NULL);
+    // fails the headless run if the level still allocates once it is past its first seconds.
+    bool check_allocations = false;
+
+    // Replays, a level played in game can be recorded, and a recording can be played back in headless mode.
+    string record_path = "";
+    string replay_path = "";
+    Replay * recording = nullptr;
+    Replay * playback = nullptr;
+
+    // Tracing, F4 (or --trace) captures the next few seconds into a Chrome trace file. Needs a profiling build.
+    string trace_path = "trace.json";
+    double trace_seconds = 5.0;
+    bool trace_on_start = false;
+
     // Private objects
-    KeyboardManager * keyboard;
-    ControllerManager * controllers;
-    Jukebox * jukebox;
+    KeyboardManager * keyboard = nullptr;
+    ControllerManager * controllers = nullptr;
+    Jukebox * jukebox = nullptr;
     Clock clock;
-    SpriteCache * cache;
-    MenuScene * menu;
-    LevelScene * game_scene;
-    Player * p1;
-    MouseManager * mouse;
-    Framebuffer * framebuffer;
-    TextCache * text;
+    Clock sim_clock;
+    FramePacer pacer;
+    SpriteCache * cache = nullptr;
+    MenuScene * menu = nullptr;
+    // the level being played, it belongs to the scene cache.
+    LevelScene * game_scene = nullptr;
+    SceneCache * scenes = nullptr;
+    Player * p1 = nullptr;
+    MouseManager * mouse = nullptr;
+    MouseManager * sim_mouse = nullptr;
+    Framebuffer * framebuffer = nullptr;
+    TextCache * text = nullptr;
+    Simulation * simulation = nullptr;
 
     // Private functions
+    void PollEvents();
+    void PostInput();
     void Process();
+    void PublishSnapshot();
+    void SimulationLoop();
+    void RunHeadless();
+    void SaveRecording();
+    void StartTrace();
+    void StopTrace();
     
 
 public:
     // Variables
-    int running;
+    atomic<int> running{false};
+    int exit_code = 0;
     bool resized = false;
     int current_width = WIDTH, current_height = HEIGHT;
     // Functions
@@ -51,6 +116,7 @@ public:
     void Loop();
     void End();
     void Render();
+    string FrameReport();
 
     ~SpaceInversion();
 };
\ No newline at end of file
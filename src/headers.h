@@ -17,6 +17,10 @@
 #include <ctime>
 #include <cstdlib>
 #include <filesystem>
+#include <random>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
@@ -26,6 +30,7 @@
 #include "clock.h"
 #include "keyboard.h"
 #include "mouse.h"
+#include "states.h"
 
 using namespace std; 
 
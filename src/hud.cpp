@@ -1,11 +1,9 @@
 #include "hud.h"
+#include "profiler.h"
 #include "string.h"
 
-Hud::Hud( SpriteCache * cache, Framebuffer * framebuffer, Player * player, TextCache * text_cache){
-    this->text_cache = text_cache;
+Hud::Hud( SpriteCache * cache, Player * player){
     this->player = player;
-    this->framebuffer = framebuffer;
-    this->renderer = framebuffer->renderer;
 
     this->life_sprite = new Sprite(cache, {}, {19, 690, 50, 50}, "resources/life.bmp");
 }
@@ -23,19 +21,19 @@ void Hud::SetScore(int score){
 }
 
 void Hud::UpdateLivesAndScore(){
-    this->lives_string = to_string(player->lives);
-    this->score_string = "Score: " + to_string(score);
+    snprintf(lives_string, sizeof(lives_string), "%d", player->lives);
+    snprintf(score_string, sizeof(score_string), "Score: %d", score);
 }
 
-void Hud::Render(){
-    framebuffer->SetActiveBuffer("HUD");
-    SDL_SetRenderDrawColor(renderer, 29, 41, 81, 255);
-    SDL_RenderClear(renderer);
+void Hud::Render(RenderSnapshot * snapshot){
+    PROFILE_ZONE("Hud::Render");
+    snapshot->SetTarget("HUD");
+    snapshot->ClearTarget({29, 41, 81, 255});
     this->UpdateLivesAndScore();
 
-    text_cache->RenderText(score_string, 19, 20, 30, {255, 255, 255, 255});
-    text_cache->RenderText(lives_string, 60, 700, 30, {255, 255, 255, 255});
-    life_sprite->Render();
+    snapshot->AddText(score_string, 19, 20, 30, {255, 255, 255, 255});
+    snapshot->AddText(lives_string, 60, 700, 30, {255, 255, 255, 255});
+    life_sprite->Render(snapshot);
 
-    framebuffer->UnsetBuffers();
+    snapshot->SetTarget(nullptr);
 }
\ No newline at end of file
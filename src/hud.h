@@ -1,31 +1,28 @@
 #pragma once
 #include "headers.h"
 #include "player.h"
-#include "framebuffer.h"
 #include "enemy.h"
-#include "text.h"
+#include "snapshot.h"
 
 class Hud{
     public:
         Player * player;
         int score = 0;
         int highscore;
-        string score_string;
-        string lives_string;
+        // formatted into fixed buffers, so the hud doesn't allocate every frame.
+        char score_string[32] = "";
+        char lives_string[16] = "";
         vector<Sprite *> life_sprites;
-        Framebuffer * framebuffer;
         int enemy_size = -1;
         Sprite * life_sprite;
-        TextCache * text_cache;
-        SDL_Renderer * renderer;
 
 
-        Hud(SpriteCache *,Framebuffer *, Player *, TextCache *);
+        Hud(SpriteCache *, Player *);
         ~Hud();
         
         void AddScore(int);
         void SetScore(int);
 
-        void Render();
+        void Render(RenderSnapshot * snapshot);
         void UpdateLivesAndScore();
 };
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "input.h"
+
+PlayerInput SampleInput(KeyboardManager * keyboard, ControllerManager * controllers){
+    PlayerInput input;
+    input.left = keyboard->KeyIsPressed(SDL_SCANCODE_A) || controllers->GetControllerButtonPressed(0, "LEFT");
+    input.right = keyboard->KeyIsPressed(SDL_SCANCODE_D) || controllers->GetControllerButtonPressed(0, "RIGHT");
+    input.fire = keyboard->KeyIsPressed(SDL_SCANCODE_SPACE) || controllers->GetControllerButtonPressed(0, "X");
+
+    input.pause = keyboard->KeyWasPressed(SDL_SCANCODE_P) || controllers->GetControllerButtonWasPressed(0, "START");
+    input.restart = keyboard->KeyWasPressed(SDL_GetScancodeFromKey(SDLK_r)) || controllers->GetControllerButtonWasPressed(0, "A");
+    input.quit = keyboard->KeyWasPressed(SDL_GetScancodeFromKey(SDLK_q)) || controllers->GetControllerButtonWasPressed(0, "X");
+    return input;
+}
+
+void InputMailbox::Post(PlayerInput * input, MouseManager * mouse){
+    lock_guard<mutex> guard(lock);
+    this->input.left = input->left;
+    this->input.right = input->right;
+    this->input.fire = input->fire;
+    this->input.pause = this->input.pause || input->pause;
+    this->input.restart = this->input.restart || input->restart;
+    this->input.quit = this->input.quit || input->quit;
+
+    mouse_x = mouse->x_pos;
+    mouse_y = mouse->y_pos;
+    mouse_clicking = mouse->clicking;
+}
+
+void InputMailbox::Take(PlayerInput * input, MouseManager * mouse){
+    lock_guard<mutex> guard(lock);
+    *input = this->input;
+    this->input.pause = false;
+    this->input.restart = false;
+    this->input.quit = false;
+
+    mouse->SetState(mouse_x, mouse_y, mouse_clicking);
+}
\ No newline at end of file
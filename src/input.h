@@ -0,0 +1,36 @@
+#pragma once
+#include "headers.h"
+#include "controller.h"
+
+// The input of one player for a single tick. The scenes only read this, so it can come from the keyboard
+// and controllers, or from somewhere else when running without a window.
+struct PlayerInput {
+    // held buttons
+    bool left = false;
+    bool right = false;
+    bool fire = false;
+
+    // buttons that were pressed this tick
+    bool pause = false;
+    bool restart = false;
+    bool quit = false;
+};
+
+PlayerInput SampleInput(KeyboardManager * keyboard, ControllerManager * controllers);
+
+/*
+    Hands the input from the thread that polls the devices to the thread that runs the simulation.
+    Held buttons are overwritten by the newest input, pressed buttons are kept until the simulation takes them,
+    so that a press is never lost when several frames go by between two ticks (or the other way around).
+*/
+class InputMailbox {
+    private:
+        mutex lock;
+        PlayerInput input;
+        int mouse_x = 0, mouse_y = 0;
+        bool mouse_clicking = false;
+
+    public:
+        void Post(PlayerInput * input, MouseManager * mouse);
+        void Take(PlayerInput * input, MouseManager * mouse);
+};
\ No newline at end of file
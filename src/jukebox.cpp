@@ -1,8 +1,13 @@
 #include "jukebox.h"
+#include "trace.h"
 
-Jukebox::Jukebox(){
+Jukebox::Jukebox(bool open_audio){
+    // without an audio device (headless mode) the jukebox stays silent and nothing is loaded.
+    if (!open_audio){
+        return;
+    }
 
-    Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 4096);
+    audio_open = Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 4096) == 0;
 
     music["title"] = LoadMusic("title_theme.wav");
     music["stage_music"] = LoadMusic("stage_music.wav");
@@ -16,6 +21,9 @@ Jukebox::Jukebox(){
 }
 
 Jukebox::~Jukebox(){
+    if (!audio_open){
+        return;
+    }
     StopMusic();
     for (auto const &song : music){
         Mix_FreeMusic(song.second);
@@ -40,6 +48,7 @@ Mix_Chunk * Jukebox::LoadSoundEffect(string effect, string filepath){
 }
 
 bool Jukebox::PlayMusic(string music, int loop){
+    if (!audio_open){return false;}
     Mix_VolumeMusic(double(music_volume/100.0)*MIX_MAX_VOLUME);
     if (!Mix_PlayingMusic()){
         if (Mix_PlayMusic(this->music[music], loop) != -1){
@@ -49,7 +58,9 @@ bool Jukebox::PlayMusic(string music, int loop){
     return false;
 }
 
-bool Jukebox::PlaySoundEffect(string effect, int loop){
+bool Jukebox::PlaySoundEffect(const string & effect, int loop){
+    TRACE_INSTANT("sound", effect.c_str());
+    if (!audio_open){return false;}
     if (Mix_VolumeChunk(sound_effects[effect],  double(sound_effect_volume/100.0) * MIX_MAX_VOLUME)){
         Mix_Volume(Mix_PlayChannel(-1, sound_effects[effect], loop), double(sound_effect_volume/100.0) * MIX_MAX_VOLUME);
         return true;
@@ -58,6 +69,7 @@ bool Jukebox::PlaySoundEffect(string effect, int loop){
 }
 
 void Jukebox::PauseMusic(){
+    if (!audio_open){return;}
     if (!music_paused){
         Mix_PauseMusic();
         music_paused = true;
@@ -65,6 +77,7 @@ void Jukebox::PauseMusic(){
 }
 
 void Jukebox::PauseSoundEffects(){
+    if (!audio_open){return;}
     if (!effects_paused){
         Mix_Pause(-1);
         effects_paused = true;
@@ -72,6 +85,7 @@ void Jukebox::PauseSoundEffects(){
 }
 
 void Jukebox::ResumeMusic(){
+    if (!audio_open){return;}
     if (music_paused){
         Mix_ResumeMusic();
         music_paused = false;
@@ -79,6 +93,7 @@ void Jukebox::ResumeMusic(){
 }
 
 void Jukebox::ResumeSoundEffects(){
+    if (!audio_open){return;}
     if (effects_paused){
         Mix_Resume(-1);
         effects_paused = false;
@@ -86,11 +101,13 @@ void Jukebox::ResumeSoundEffects(){
 }
 
 void Jukebox::StopMusic(){
+    if (!audio_open){return;}
     Mix_HaltMusic();
     music_paused = false;
 }
 
 void Jukebox::StopSoundEffects(){
+    if (!audio_open){return;}
     Mix_HaltChannel(-1);
     effects_paused = false;
 }
@@ -10,14 +10,15 @@ class Jukebox {
         bool music_paused = false;
         bool effects_paused = false;
         int sound_effect_volume = 40;
+        bool audio_open = false;
 
-        Jukebox();
+        Jukebox(bool open_audio = true);
         ~Jukebox();
 
         Mix_Music * LoadMusic(string, string filepath = "resources/sounds/music/");
         Mix_Chunk * LoadSoundEffect(string, string filepath = "resources/sounds/effects/");
         bool PlayMusic(string music = "", int loop = -1);
-        bool PlaySoundEffect(string, int loop = 0);
+        bool PlaySoundEffect(const string &, int loop = 0);
         void PauseMusic();
         void PauseSoundEffects();
         void ResumeMusic();
@@ -1,4 +1,5 @@
 #include "keyboard.h"
+#include "profiler.h"
 
 KeyboardManager::KeyboardManager(){
     SDL_memset(previous_keystate, 0 , sizeof(Uint8)*SDL_NUM_SCANCODES);
@@ -7,6 +8,7 @@ KeyboardManager::KeyboardManager(){
 }
 
 void KeyboardManager::Process(){
+    PROFILE_ZONE("KeyboardManager::Process");
     /* 
         The state of the previous keys are kept to make sure that we can properly process
         if a key WAS pressed, or if it is currently BEING pressed.
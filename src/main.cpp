@@ -45,12 +45,24 @@ int Filter(void * userdata, SDL_Event * event){
 }
 
 #ifdef __EMSCRIPTEN__
+SpaceInversion * browser_game = nullptr;
+
 void RunAppLoop(void * userdata){
     SpaceInversion * game = static_cast<SpaceInversion*>(userdata);
     game->Loop();
 }
+
+// Called by the page (templates/SpaceInversion.html) to show how the frames are paced in the browser.
+extern "C" EMSCRIPTEN_KEEPALIVE const char * GetFrameReport(){
+    static string report;
+    if (!browser_game){return "{}";}
+    report = browser_game->FrameReport();
+    return report.c_str();
+}
 #endif
 
+// Tools like the replay farm are built with the game sources and bring their own main.
+#ifndef SPACE_INVERSION_NO_MAIN
 int main(int argc, char ** argv){
     SpaceInversion game;
 
@@ -60,11 +72,14 @@ int main(int argc, char ** argv){
 
     SDL_SetEventFilter(Filter, (void*)&game);
     #ifdef __EMSCRIPTEN__
-    emscripten_set_main_loop_arg(RunAppLoop, (void*)&game, 60, 1);
+    // A frame rate of 0 lets the browser schedule the frames with requestAnimationFrame, so they follow the display
+    // whatever its refresh rate is. The fixed timestep keeps the game speed the same on every display.
+    browser_game = &game;
+    emscripten_set_main_loop_arg(RunAppLoop, (void*)&game, 0, 1);
     #else 
     game.Loop();
     #endif
    
-    return 0;
+    return game.exit_code;
 }
-
+#endif
\ No newline at end of file
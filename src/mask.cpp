@@ -0,0 +1,79 @@
+#include "mask.h"
+
+CollisionMask::CollisionMask(int w, int h){
+    this->w = w;
+    this->h = h;
+    words = (w + 63) / 64;
+    bits.assign(size_t(words) * h, 0);
+}
+
+bool CollisionMask::Solid() const {
+    return bits.empty();
+}
+
+void CollisionMask::Set(int x, int y){
+    bits[y * words + x / 64] |= Uint64(1) << (x % 64);
+}
+
+Uint64 CollisionMask::Bits(int y, int x) const {
+    const Uint64 * row = &bits[y * words];
+    int word = x / 64, shift = x % 64;
+    Uint64 pixels = row[word] >> shift;
+    if (shift && word + 1 < words){
+        pixels |= row[word + 1] << (64 - shift);
+    }
+    return pixels;
+}
+
+// the first count bits.
+static Uint64 Low(int count){
+    return count >= 64 ? ~Uint64(0) : (Uint64(1) << count) - 1;
+}
+
+// a mask that can't be used as it is (solid, or not as big as where it is placed) is tested as its rect.
+static bool Usable(const CollisionMask &mask, const SDL_Rect &where){
+    return !mask.Solid() && mask.w == where.w && mask.h == where.h;
+}
+
+bool MaskTouchesRect(const CollisionMask &mask, const SDL_Rect &where, const SDL_Rect &rect){
+    SDL_Rect overlap;
+    if (!SDL_IntersectRect(&where, &rect, &overlap)){
+        return false;
+    }
+    if (!Usable(mask, where)){
+        return true;
+    }
+    int x = overlap.x - where.x;
+    for (int y = overlap.y - where.y; y < overlap.y - where.y + overlap.h; y++){
+        for (int done = 0; done < overlap.w; done += 64){
+            if (mask.Bits(y, x + done) & Low(overlap.w - done)){
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool MasksOverlap(const CollisionMask &a, const SDL_Rect &where_a, const CollisionMask &b, const SDL_Rect &where_b){
+    if (!Usable(a, where_a)){
+        return MaskTouchesRect(b, where_b, where_a);
+    }
+    if (!Usable(b, where_b)){
+        return MaskTouchesRect(a, where_a, where_b);
+    }
+    SDL_Rect overlap;
+    if (!SDL_IntersectRect(&where_a, &where_b, &overlap)){
+        return false;
+    }
+    // the same pixels of the screen are at different places in the two masks.
+    int xa = overlap.x - where_a.x, xb = overlap.x - where_b.x;
+    int ya = overlap.y - where_a.y, yb = overlap.y - where_b.y;
+    for (int row = 0; row < overlap.h; row++){
+        for (int done = 0; done < overlap.w; done += 64){
+            if (a.Bits(ya + row, xa + done) & b.Bits(yb + row, xb + done) & Low(overlap.w - done)){
+                return true;
+            }
+        }
+    }
+    return false;
+}
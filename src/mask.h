@@ -0,0 +1,29 @@
+#pragma once
+#include "headers.h"
+
+/*
+    One bit for every pixel of a sprite frame the way it is drawn, set where the pixel isn't transparent. The
+    SpriteCache builds them once, when the things that are hit are made, so hits can be tested against the shape of a
+    sprite instead of its whole rect without reading any pixels while the game runs.
+    Every row is packed into 64-bit words: pixel x of row y is bit x % 64 of bits[y * words + x / 64]. A mask
+    without any pixels stands for a sprite whose image couldn't be read, and is solid.
+*/
+struct CollisionMask {
+    int w = 0, h = 0;
+    int words = 0;
+    vector<Uint64> bits;
+
+    CollisionMask() {}
+    CollisionMask(int w, int h);
+    bool Solid() const;
+    void Set(int x, int y);
+    // 64 pixels of row y from pixel x on, the ones past the end of the row are clear.
+    Uint64 Bits(int y, int x) const;
+};
+
+// the narrow phase, only worth it after the rects were found to intersect. A mask is placed at where, which has to
+// be as big as the mask.
+// whether a pixel of the mask is inside rect.
+bool MaskTouchesRect(const CollisionMask &mask, const SDL_Rect &where, const SDL_Rect &rect);
+// whether the masks have a pixel in the same place, rows are tested 64 pixels at a time.
+bool MasksOverlap(const CollisionMask &a, const SDL_Rect &where_a, const CollisionMask &b, const SDL_Rect &where_b);
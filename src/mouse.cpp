@@ -34,6 +34,17 @@ void MouseManager::Process(){
     mouse_rect.y = (y_pos - int(mouse_rect.h / 2));
 }
 
+void MouseManager::SetState(int x, int y, bool clicking){
+    // used when the mouse is polled on another thread, does the same as Process with the given state.
+    x_pos = x;
+    y_pos = y;
+    this->clicking = clicking;
+    has_clicked = clicked && !clicking;
+    clicked = clicking;
+    mouse_rect.x = (x_pos - int(mouse_rect.w / 2));
+    mouse_rect.y = (y_pos - int(mouse_rect.h / 2));
+}
+
 bool MouseManager::IsClicking(SDL_Rect * rect){
     return IsTouching(rect) && clicking;
 }
@@ -20,6 +20,7 @@ class MouseManager{
         bool HasClicked(SDL_Rect * rect);
         bool IsTouching(SDL_Rect * rect);
         void ResetState();
+        void SetState(int x, int y, bool clicking);
 
         void Render(SDL_Renderer * renderer);
 };
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "overlap.h"
+#include <climits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define OVERLAP_SSE2
+#if defined(__GNUC__)
+// the AVX2 kernel is compiled for AVX2 on its own and only picked when the CPU has it.
+#define OVERLAP_AVX2
+#endif
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define OVERLAP_SIMD128
+#endif
+
+RectBatch::RectBatch(Arena * arena) : left(arena), top(arena), right(arena), bottom(arena) {}
+
+int RectBatch::Size() const {
+    return int(left.size());
+}
+
+void RectBatch::Clear(){
+    left.clear();
+    top.clear();
+    right.clear();
+    bottom.clear();
+}
+
+void RectBatch::Resize(int count){
+    left.resize(count);
+    top.resize(count);
+    right.resize(count);
+    bottom.resize(count);
+}
+
+void RectBatch::Set(int i, const SDL_Rect &rect){
+    if (rect.w <= 0 || rect.h <= 0){
+        left[i] = top[i] = INT_MAX;
+        right[i] = bottom[i] = INT_MIN;
+        return;
+    }
+    left[i] = rect.x;
+    top[i] = rect.y;
+    right[i] = rect.x + rect.w;
+    bottom[i] = rect.y + rect.h;
+}
+
+void RectBatch::Add(const SDL_Rect &rect){
+    Resize(Size() + 1);
+    Set(Size() - 1, rect);
+}
+
+// the edges of the batch from the first rect to be tested, and the edges of the rect they are tested against.
+struct OverlapJob {
+    const int * left;
+    const int * top;
+    const int * right;
+    const int * bottom;
+    int count;
+    int rect_left, rect_top, rect_right, rect_bottom;
+};
+
+// the masks are cleared before a kernel runs, every kernel sets the bits from start on one at a time.
+static void OverlapScalar(const OverlapJob &job, int start, Uint32 * masks){
+    for (int i = start; i < job.count; i++){
+        bool hit = job.left[i] < job.rect_right && job.rect_left < job.right[i] &&
+                   job.top[i] < job.rect_bottom && job.rect_top < job.bottom[i];
+        masks[i >> 5] |= Uint32(hit) << (i & 31);
+    }
+}
+
+#ifdef OVERLAP_SSE2
+static void OverlapSSE2(const OverlapJob &job, Uint32 * masks){
+    __m128i rect_left = _mm_set1_epi32(job.rect_left), rect_top = _mm_set1_epi32(job.rect_top);
+    __m128i rect_right = _mm_set1_epi32(job.rect_right), rect_bottom = _mm_set1_epi32(job.rect_bottom);
+    int i = 0;
+    for (; i + 4 <= job.count; i += 4){
+        __m128i hit = _mm_and_si128(
+            _mm_and_si128(_mm_cmplt_epi32(_mm_loadu_si128((const __m128i *)(job.left + i)), rect_right),
+                          _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i *)(job.right + i)), rect_left)),
+            _mm_and_si128(_mm_cmplt_epi32(_mm_loadu_si128((const __m128i *)(job.top + i)), rect_bottom),
+                          _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i *)(job.bottom + i)), rect_top)));
+        masks[i >> 5] |= Uint32(_mm_movemask_ps(_mm_castsi128_ps(hit))) << (i & 31);
+    }
+    OverlapScalar(job, i, masks);
+}
+#endif
+
+#ifdef OVERLAP_AVX2
+__attribute__((target("avx2")))
+static void OverlapAVX2(const OverlapJob &job, Uint32 * masks){
+    __m256i rect_left = _mm256_set1_epi32(job.rect_left), rect_top = _mm256_set1_epi32(job.rect_top);
+    __m256i rect_right = _mm256_set1_epi32(job.rect_right), rect_bottom = _mm256_set1_epi32(job.rect_bottom);
+    int i = 0;
+    for (; i + 8 <= job.count; i += 8){
+        // there is no less-than for integers, so a < b is b > a.
+        __m256i hit = _mm256_and_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi32(rect_right, _mm256_loadu_si256((const __m256i *)(job.left + i))),
+                             _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i *)(job.right + i)), rect_left)),
+            _mm256_and_si256(_mm256_cmpgt_epi32(rect_bottom, _mm256_loadu_si256((const __m256i *)(job.top + i))),
+                             _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i *)(job.bottom + i)), rect_top)));
+        masks[i >> 5] |= Uint32(_mm256_movemask_ps(_mm256_castsi256_ps(hit))) << (i & 31);
+    }
+    // the compiler doesn't clear the upper halves by itself in a function built for AVX2 on its own, and SSE code
+    // after it would pay for every instruction until they are.
+    _mm256_zeroupper();
+    OverlapScalar(job, i, masks);
+}
+#endif
+
+#ifdef OVERLAP_SIMD128
+static void OverlapSIMD128(const OverlapJob &job, Uint32 * masks){
+    v128_t rect_left = wasm_i32x4_splat(job.rect_left), rect_top = wasm_i32x4_splat(job.rect_top);
+    v128_t rect_right = wasm_i32x4_splat(job.rect_right), rect_bottom = wasm_i32x4_splat(job.rect_bottom);
+    int i = 0;
+    for (; i + 4 <= job.count; i += 4){
+        v128_t hit = wasm_v128_and(
+            wasm_v128_and(wasm_i32x4_lt(wasm_v128_load(job.left + i), rect_right),
+                          wasm_i32x4_gt(wasm_v128_load(job.right + i), rect_left)),
+            wasm_v128_and(wasm_i32x4_lt(wasm_v128_load(job.top + i), rect_bottom),
+                          wasm_i32x4_gt(wasm_v128_load(job.bottom + i), rect_top)));
+        masks[i >> 5] |= Uint32(wasm_i32x4_bitmask(hit)) << (i & 31);
+    }
+    OverlapScalar(job, i, masks);
+}
+#endif
+
+#if !defined(OVERLAP_SSE2) && !defined(OVERLAP_SIMD128)
+static void OverlapPlain(const OverlapJob &job, Uint32 * masks){
+    OverlapScalar(job, 0, masks);
+}
+#endif
+
+struct OverlapKernelInfo {
+    void (*run)(const OverlapJob &, Uint32 *);
+    const char * name;
+};
+
+// picked the first time it is needed, the CPU doesn't change while the game runs.
+static const OverlapKernelInfo &Kernel(){
+    static const OverlapKernelInfo kernel = [](){
+        #ifdef OVERLAP_AVX2
+        if (__builtin_cpu_supports("avx2")){
+            return OverlapKernelInfo{OverlapAVX2, "avx2"};
+        }
+        #endif
+        #if defined(OVERLAP_SSE2)
+        return OverlapKernelInfo{OverlapSSE2, "sse2"};
+        #elif defined(OVERLAP_SIMD128)
+        return OverlapKernelInfo{OverlapSIMD128, "simd128"};
+        #else
+        return OverlapKernelInfo{OverlapPlain, "scalar"};
+        #endif
+    }();
+    return kernel;
+}
+
+void OverlapMask(const SDL_Rect &rect, const RectBatch &batch, int first, int count, Uint32 * masks){
+    memset(masks, 0, MaskWords(count) * sizeof(Uint32));
+    // SDL_HasIntersection is false for an empty rect, and so is every bit.
+    if (count <= 0 || rect.w <= 0 || rect.h <= 0){
+        return;
+    }
+    OverlapJob job;
+    job.left = batch.left.data() + first;
+    job.top = batch.top.data() + first;
+    job.right = batch.right.data() + first;
+    job.bottom = batch.bottom.data() + first;
+    job.count = count;
+    job.rect_left = rect.x;
+    job.rect_top = rect.y;
+    job.rect_right = rect.x + rect.w;
+    job.rect_bottom = rect.y + rect.h;
+    Kernel().run(job, masks);
+}
+
+void OverlapMasks(const RectBatch &rects, const RectBatch &targets, Uint32 * masks){
+    int words = MaskWords(targets.Size());
+    for (int r = 0; r < rects.Size(); r++){
+        // an empty rect was stored inside out, it stays empty so OverlapMask turns it away.
+        SDL_Rect rect = {rects.left[r], rects.top[r], 0, 0};
+        if (rects.left[r] < rects.right[r]){
+            rect.w = rects.right[r] - rects.left[r];
+            rect.h = rects.bottom[r] - rects.top[r];
+        }
+        OverlapMask(rect, targets, 0, targets.Size(), masks + r * words);
+    }
+}
+
+const char * OverlapKernel(){
+    return Kernel().name;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "headers.h"
+#include "arena.h"
+
+/*
+    Rects packed one coordinate to an array, as their edges, so many of them can be tested against a rect at once.
+    Rect i covers left[i] <= x < right[i] and top[i] <= y < bottom[i]. An empty rect is stored so nothing overlaps it.
+*/
+class RectBatch {
+    public:
+        ArenaVector<int> left, top, right, bottom;
+
+        RectBatch(Arena * arena = nullptr);
+        int Size() const;
+        void Clear();
+        void Resize(int count);
+        void Set(int i, const SDL_Rect &rect);
+        void Add(const SDL_Rect &rect);
+};
+
+// how many words a mask of count rects takes, rect i is bit i % 32 of word i / 32.
+inline int MaskWords(int count){
+    return (count + 31) / 32;
+}
+
+/*
+    The batch kernels, they give the same answers as SDL_HasIntersection on every pair, as bits in masks.
+    They use AVX2 when the CPU has it, SSE2 on any other x86-64 CPU, SIMD128 in a WebAssembly build made with
+    -msimd128, and plain code anywhere else.
+*/
+
+// sets bit i of masks when rect intersects rect first + i of the batch, for count rects. Every bit past count in
+// the last word is cleared.
+void OverlapMask(const SDL_Rect &rect, const RectBatch &batch, int first, int count, Uint32 * masks);
+// tests every rect of rects against every rect of targets. The mask of rects[r] starts at masks[r * words],
+// with words = MaskWords(targets.Size()).
+void OverlapMasks(const RectBatch &rects, const RectBatch &targets, Uint32 * masks);
+// the name of the kernel OverlapMask uses on this machine.
+const char * OverlapKernel();
@@ -0,0 +1,78 @@
+#include "pacer.h"
+
+FramePacer::FramePacer(double target_fps, bool vsync){
+    frequency = SDL_GetPerformanceFrequency();
+    if (!frequency){
+        frequency = 1000;
+    }
+    this->vsync = vsync;
+    SetTargetRate(target_fps);
+}
+
+void FramePacer::SetTargetRate(double fps){
+    target_fps = fps;
+    if (target_fps > 0){
+        frame_period = Uint64(frequency / target_fps);
+    }
+    else {
+        frame_period = 0;
+    }
+    next_deadline = 0;
+}
+
+void FramePacer::SetRefreshRate(double hz){
+    if (hz > 0){
+        refresh_period_s = 1.0 / hz;
+    }
+}
+
+void FramePacer::EndPresent(){
+    Uint64 present_end = SDL_GetPerformanceCounter();
+    presented_frames++;
+
+    /*
+        With vsync every present finishes on a refresh, so the time between two presents is a whole
+        number of refresh intervals. A capped frame rate below the refresh rate waits that many intervals
+        on purpose, so only the intervals past the expected gap (one refresh, or one frame period if that
+        is longer) mean a refresh went by without a new frame, and are counted as dropped frames.
+    */
+    if (vsync && last_present_end){
+        double interval = double(present_end - last_present_end) / frequency;
+        double expected = max(refresh_period_s, double(frame_period) / frequency);
+        int intervals = int(interval / refresh_period_s + .5);
+        int expected_intervals = max(1, int(expected / refresh_period_s + .5));
+        if (intervals > expected_intervals){
+            dropped_frames += intervals - expected_intervals;
+        }
+    }
+    last_present_end = present_end;
+}
+
+void FramePacer::Wait(){
+    if (!frame_period){
+        return;
+    }
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (!next_deadline){
+        next_deadline = now + frame_period;
+    }
+
+    // sleep for most of the remaining time, then spin until the deadline is reached.
+    if (now < next_deadline){
+        double remaining_s = double(next_deadline - now) / frequency;
+        if (remaining_s > spin_time_s){
+            SDL_Delay(Uint32((remaining_s - spin_time_s) * 1000));
+        }
+        while (SDL_GetPerformanceCounter() < next_deadline){}
+        now = SDL_GetPerformanceCounter();
+    }
+
+    // if we're already past the next frame's deadline, the frame was late and the deadlines are restarted from now
+    // instead of trying to catch up with a burst of frames.
+    next_deadline += frame_period;
+    if (now >= next_deadline){
+        late_frames++;
+        next_deadline = now + frame_period;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+#include "headers.h"
+
+/*
+    The frame pacer replaces the fixed delay at the end of the main loop. It sleeps until the deadline of
+    the next frame and spins for the last bit of time, since the OS can oversleep by a few milliseconds.
+    It also times the gaps between presented frames so that missed vsync intervals can be counted as dropped frames.
+*/
+class FramePacer {
+    private:
+        Uint64 frequency;
+        Uint64 frame_period = 0;
+        Uint64 next_deadline = 0;
+        Uint64 last_present_end = 0;
+        double refresh_period_s = 1.0 / 60.0;
+
+    public:
+        // a target of 0 means uncapped, in which case only vsync (if enabled) limits the frame rate.
+        double target_fps = 0.0;
+        // time before the deadline that is spent spinning instead of sleeping.
+        double spin_time_s = .002;
+        bool vsync = true;
+
+        int presented_frames = 0;
+        int dropped_frames = 0;
+        int late_frames = 0;
+
+        FramePacer(double target_fps = 0.0, bool vsync = true);
+
+        void SetTargetRate(double fps);
+        void SetRefreshRate(double hz);
+        void EndPresent();
+        void Wait();
+};
\ No newline at end of file
@@ -1,11 +1,13 @@
 #include "player.h"
 #include "projectile.h"
+#include "trace.h"
 
 Player::Player(SpriteCache * cache, int x, int y, int w, int h, string src, SDL_RendererFlip flip){
-    renderer = cache->renderer;
     this->cache = cache;
     x_pos = x;
     y_pos = y;
+    last_x = x;
+    last_y = y;
     starting_xpos = x;
     starting_ypos = y;
     width = w;
@@ -19,68 +21,71 @@ Player::Player(SpriteCache * cache, int x, int y, int w, int h, string src, SDL_
     dead = false;
     moving = false;
 
-    sprites["DEFAULT"] = new Sprite(cache, {30, 24, 37, 37}, d_rect, src);
-    sprites["DYING"] = new AnimatedSprite(cache, {0, 0, 64, 64}, {d_rect.x, d_rect.y, d_rect.w + 60, d_rect.h + 60}, "resources/explosion.bmp", 64, 4, .1);
-    sprites["RESPAWNING"] = new AnimatedSprite(cache, {30, 24, 37, 37}, d_rect, src, -37, 2, .03);
-    sprites["DEAD"] = new Sprite(cache, {-30, 24, 37, 37}, d_rect, src);
-    state = "DEFAULT";
+    clips[PLAYER_DEFAULT] = cache->AddClip(src, {30, 24, 37, 37});
+    clips[PLAYER_DYING] = cache->AddClip("resources/explosion.bmp", {0, 0, 64, 64}, 64, 4, .1, 60);
+    clips[PLAYER_RESPAWNING] = cache->AddClip(src, {30, 24, 37, 37}, -37, 2, .03);
+    clips[PLAYER_DEAD] = cache->AddClip(src, {-30, 24, 37, 37});
+    laser_clip = Laser::Clip(cache);
+    mask = cache->AddMask(clips[PLAYER_DEFAULT], w, h);
+    state = PLAYER_DEFAULT;
+    cache->Play(&playhead, clips[state]);
     cooldown_time = .3;
+    bullets.Reserve(max_projectiles);
 }
 
 void Player::Process(Clock * clock){
+    // keep the position of the last tick so rendering can interpolate between the two.
+    last_x = x_pos;
+    last_y = y_pos;
+
     // if the player is moving, move either left or right.
     if (moving){
-        if (direction == "left"){
+        if (direction == DIRECTION_LEFT){
             x_pos -= ((speed * 10) * clock->delta_time_s);
         }
-        if (direction == "right"){
+        if (direction == DIRECTION_RIGHT){
             x_pos += ((speed * 10) * clock->delta_time_s);
         }
     }
 
-    if (state == "DYING"){
-        if (sprites[state]->finished){
-            sprites[state]->Reset();
+    if (state == PLAYER_DYING){
+        cache->Play(&playhead, clips[state]);
+        if (playhead.finished){
             if (lives >= 1){
-                state = "RESPAWNING";
+                state = player_transitions[state][PLAYER_EXPLODED];
             }
             else {
-                state = "DEAD";
+                state = player_transitions[state][PLAYER_OUT_OF_LIVES];
                 dead = true;
             }
             
         }
     }
 
-    if (state == "DEAD"){
+    if (state == PLAYER_DEAD){
         SetPos(starting_xpos, starting_ypos);
     }
 
-    if (state == "RESPAWNING"){
+    if (state == PLAYER_RESPAWNING){
         respawn_timer += clock->delta_time_s;
         if (respawn_timer >= respawning_time){
             respawn_timer = 0.0;
-            state = "DEFAULT";  
+            state = player_transitions[state][PLAYER_RESPAWNED];
         }
     }
 
-    // move bullets in the list/vector up screen.
+    // move bullets up screen, and retire them if they are off screen or if they hit something.
+    // a retired bullet is replaced by the last one, which still has to be moved, so i only goes on when nothing was retired.
     int i = 0;
-    for (auto bullet: bullets){
-        
-        bullet->Process(clock);
-        if (bullet->y_pos <= 0){
-            if (find(erased.begin(), erased.end(), i) == erased.end()){
-                erased.push_back(i);
-            }
+    while (i < bullets.Size()){
+        Projectile &bullet = bullets.At(i);
+        bullet.Process(clock);
+        if (bullet.hit || bullet.y_pos <= 0){
+            bullets.Retire(i);
+        }
+        else {
+            i++;
         }
-        i++;
-    }
-
-    // erase bullets if they are off screen or if they hit something.
-    for (auto index: erased){
-        delete bullets[index];
-        bullets.erase(bullets.begin()+index);
     }
 
     // if there is a cooldown, count down the cooldown until it reaches the limit, then disable the cooldown.
@@ -93,14 +98,14 @@ void Player::Process(Clock * clock){
         }
     }
 
-    // Animate the current sprite if it has an animation 
-    sprites[state]->Animate(clock);
-    
-    erased.clear();
+    // Animate the clip of the current state
+    cache->Play(&playhead, clips[state]);
+    cache->Advance(&playhead, 1, clock->delta_time_s);
+    UpdateRect();
 }
 
-void Player::Move(string d){
-    if ((d == "none") || (state == "DYING") || (state == "DEAD")){
+void Player::Move(Direction d){
+    if ((d == DIRECTION_NONE) || (state == PLAYER_DYING) || (state == PLAYER_DEAD)){
         this->moving = false;
     }   
     else {
@@ -112,10 +117,10 @@ void Player::Move(string d){
 
 bool Player::Attack(){
     // we check the size of the bullet array to make sure that only 3 bullets are on screen at once.
-    if (state == "DEFAULT"){
-        if ((bullets.size() < max_projectiles) && !attack_cooldown){
-            bullets.push_back(
-                new Laser(cache, x_pos,
+    if (state == PLAYER_DEFAULT){
+        if ((bullets.Size() < max_projectiles) && !attack_cooldown){
+            bullets.Fire(
+                Laser(cache, laser_clip, x_pos,
                                     (d_rect.y + (d_rect.w/2)) - 10, 15, 20, 90, {0, 255, 0, 255}, projectile_speed)
             );
             attack_cooldown = true;
@@ -130,26 +135,23 @@ void Player::SetPos(int x, int y){
     starting_ypos = y;
     x_pos = x;
     y_pos = y;
+    last_x = x;
+    last_y = y;
 }
 
 void Player::Hurt(){
+    TRACE_INSTANT("player hit", "");
     lives -= 1;
-    state = "DYING";
+    state = player_transitions[state][PLAYER_HIT];
 }
 
 void Player::Reset(){
-    for (auto sprite : sprites){
-        sprite.second->Reset();
-    }
-    state = "DEFAULT";
+    cache->Rewind(&playhead);
+    state = player_transitions[state][PLAYER_RESET];
     SetPos(starting_xpos, starting_ypos);
-    for (int i = 0; i < int(bullets.size()); i++){
-        if (find(erased.begin(), erased.end(), i) == erased.end()){
-            delete bullets[i];
-            bullets.erase(bullets.begin() + i);
-        }  
-    }
+    bullets.Clear();
     lives = starting_life;
+    moving = false;
     respawn_timer = 0.0;
     attack_cooldown = false;
     respawn_timer = 0;
@@ -157,46 +159,30 @@ void Player::Reset(){
     dead = false;
 }
 
-bool Player::TouchingBullet(SDL_Rect * rect){
-    for (auto bullet: bullets){
-        if (SDL_HasIntersection(&bullet->hitbox, rect)){
-            return true;
-        }
-    }
-    return false;
+void Player::UpdateRect(){
+    // the collision rect follows the simulated position, not the interpolated one that is rendered.
+    d_rect.x = (x_pos - int(d_rect.w / 2));
+    d_rect.y = (y_pos - int(d_rect.h / 2));
+    d_rect.w = width + cache->GetClip(clips[state]).grow;
+    d_rect.h = height + cache->GetClip(clips[state]).grow;
 }
 
-bool Player::TouchingEnemy(SDL_Rect * rect){
-    return SDL_HasIntersection(&d_rect, rect);
+const CollisionMask & Player::Mask(){
+    return cache->GetMask(mask);
 }
 
-void Player::Render(){
-    d_rect.x = (x_pos - int(d_rect.w / 2));
-    d_rect.y = (y_pos - int(d_rect.h / 2));
-    d_rect.w = sprites[state]->d_rect.w;
-    d_rect.h = sprites[state]->d_rect.h;
+bool Player::Touches(const SDL_Rect &rect){
+    return MaskTouchesRect(Mask(), d_rect, rect);
+}
 
-    // Set the position of the rendered sprite to be the same position as the player
-    sprites[state]->SetPos(x_pos, y_pos);
-    
+void Player::Render(RenderSnapshot * snapshot){
     // Render any bullets if they exist.
-    for (auto bullet: bullets){
-        bullet->Render();
+    for (auto &bullet: bullets){
+        bullet.Render(snapshot);
     }
 
-    // Render the player ship.
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-   sprites[state]->Render();
+    // Render the player ship, in between the last and current tick.
+    cache->RenderClip(snapshot, clips[state], &playhead, width, height, int(x_pos), int(y_pos), last_x, last_y);
 }
 
-Player::~Player(){
-    for (auto const sprite: sprites){
-        delete sprite.second;
-    }
-
-    for (int i = 0; i < bullets.size(); i++){
-        delete bullets[i];
-        bullets.erase(bullets.begin() + i);
-    }
-
-}
\ No newline at end of file
+Player::~Player(){}
\ No newline at end of file
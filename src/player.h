@@ -5,22 +5,26 @@
 
 class Player{
 private:
-    map<string, Sprite *> sprites;
+    // the clip of every state, and where the player is in the clip of the current state.
+    int clips[PLAYER_STATE_COUNT] = {};
+    Playhead playhead;
+    int laser_clip;
+    // the collision mask of the ship while it can be hit.
+    int mask;
     SDL_RendererFlip orientation;
     int width, height;
     bool moving;
-    string direction;
-    SDL_Renderer * renderer;
+    Direction direction = DIRECTION_NONE;
     SpriteCache * cache;
     bool shield;
     double starting_xpos = 0, starting_ypos = 0;
 
 public:
-    vector<int> erased;
-    string state;
+    PlayerState state = PLAYER_DEFAULT;
     SDL_Rect d_rect = {};
     bool dead = false;
     double x_pos = 0, y_pos = 0;
+    double last_x = 0, last_y = 0;
     int starting_life = 3;
     int lives = starting_life;
     int projectile_speed = 4;
@@ -32,18 +36,20 @@ public:
     double respawning_time = 2;
     int max_projectiles = 3;
     bool attacking = false;
-    vector<Projectile *> bullets = {};
+    ProjectilePool bullets;
     Player(SpriteCache * cache, int x, int y, int w, int h, string src, SDL_RendererFlip flip = SDL_FLIP_NONE);
 
     void Process(Clock * clock);
-    void Move(string d);
+    void Move(Direction d);
     bool Attack();
     void Hurt();
     void SetPos(int, int);
-    bool TouchingBullet(SDL_Rect * rect);
-    bool TouchingEnemy(SDL_Rect * rect);
     void Reset();
+    void UpdateRect();
+    // whether rect touches the pixels of the ship.
+    bool Touches(const SDL_Rect &rect);
+    const CollisionMask & Mask();
 
-    void Render();
+    void Render(RenderSnapshot * snapshot);
     ~Player();
 };
\ No newline at end of file
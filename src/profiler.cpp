@@ -0,0 +1,135 @@
+#include "profiler.h"
+#include "arena.h"
+
+Profiler profiler;
+
+Profiler::Profiler(){
+    frequency = (double)SDL_GetPerformanceFrequency();
+}
+
+int Profiler::Register(const char * name){
+    // Called once per zone, the first time it is hit.
+    lock_guard<mutex> guard(lock);
+    int count = zone_count.load();
+    for (int i = 0; i < count; i++){
+        if (strcmp(zones[i].name, name) == 0){
+            return i;
+        }
+    }
+    if (count == MAX_ZONES){
+        return -1;
+    }
+    zones[count].name = name;
+    zone_count.store(count + 1);
+    return count;
+}
+
+void Profiler::Add(int zone, Uint64 start, Uint64 end, Uint64 allocations){
+    if (zone < 0){return;}
+    zones[zone].current_ns.fetch_add(Uint64((end - start) * 1e9 / frequency), memory_order_relaxed);
+    zones[zone].current_allocations.fetch_add(allocations, memory_order_relaxed);
+}
+
+void Profiler::EndFrame(double frame_ms){
+    // Move the time gathered during the frame into the history, the ticks of the simulation thread count
+    // towards the frame they finished in.
+    int count = zone_count.load();
+    for (int i = 0; i < count; i++){
+        zones[i].history[history_index] = zones[i].current_ns.exchange(0, memory_order_relaxed);
+        zones[i].allocation_history[history_index] = zones[i].current_allocations.exchange(0, memory_order_relaxed);
+    }
+    frame_times[history_index] = frame_ms;
+
+    AllocationStats allocations = Allocations::Totals();
+    frame_allocations[history_index] = allocations.allocations - last_allocations.allocations;
+    frame_bytes[history_index] = allocations.bytes - last_allocations.bytes;
+    last_allocations = allocations;
+
+    history_index = (history_index + 1) % ProfileZone::HISTORY;
+    history_count = min(history_count + 1, int(ProfileZone::HISTORY));
+}
+
+void Profiler::Render(SDL_Renderer * renderer, TextCache * text, int x, int y){
+    if (!visible || history_count == 0){return;}
+
+    int count = zone_count.load();
+    int line = 14;
+    int graph_height = 100;
+    int width = 400;
+    int height = (count + 4) * line + graph_height + 20;
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 190);
+    SDL_Rect background = {x, y, width, height};
+    SDL_RenderFillRect(renderer, &background);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    // The font only has upper case letters, so everything is printed in caps.
+    char buffer[64];
+    int length = snprintf(buffer, sizeof(buffer), "%-24s%7s%7s%7s%s", "ZONE", "AVG", "MAX", "ALLOCS", tracer.recording ? "  TRACING" : "");
+    text->RenderText(buffer, length, x + 10, y + 10, 8, {255, 255, 0, 255}, 1);
+
+    for (int i = 0; i < count; i++){
+        Uint64 total = 0, max_ns = 0, allocations = 0;
+        for (int j = 0; j < history_count; j++){
+            total += zones[i].history[j];
+            max_ns = max(max_ns, zones[i].history[j]);
+            allocations += zones[i].allocation_history[j];
+        }
+        double avg_ms = total / 1e6 / history_count;
+
+        length = snprintf(buffer, sizeof(buffer), "%-24.24s%7.2f%7.2f%7.1f", zones[i].name, avg_ms, max_ns / 1e6,
+                          double(allocations) / history_count);
+        for (int c = 0; c < length; c++){
+            buffer[c] = toupper(buffer[c]);
+        }
+        text->RenderText(buffer, length, x + 10, y + 10 + (i + 1) * line, 8, {255, 255, 255, 255}, 1);
+    }
+
+    // Frame time graph, oldest frame on the left. 2 pixels per millisecond, with a line at 60 fps.
+    int graph_y = y + 10 + (count + 1) * line + graph_height;
+    double frame_total = 0.0, frame_max = 0.0;
+    Uint64 allocations = 0, bytes = 0;
+    int bar_width = (width - 20) / ProfileZone::HISTORY;
+    for (int j = 0; j < history_count; j++){
+        int index = (history_index - history_count + j + ProfileZone::HISTORY) % ProfileZone::HISTORY;
+        double ms = frame_times[index];
+        frame_total += ms;
+        frame_max = max(frame_max, ms);
+        allocations += frame_allocations[index];
+        bytes += frame_bytes[index];
+
+        int bar_height = min(int(ms * 2), graph_height);
+        if (ms > 1000.0 / 60.0){
+            SDL_SetRenderDrawColor(renderer, 220, 60, 60, 255);
+        }
+        else {
+            SDL_SetRenderDrawColor(renderer, 60, 200, 90, 255);
+        }
+        SDL_Rect bar = {x + 10 + j * bar_width, graph_y - bar_height, max(bar_width - 1, 1), bar_height};
+        SDL_RenderFillRect(renderer, &bar);
+    }
+    SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
+    int budget_y = graph_y - int(1000.0 / 60.0 * 2);
+    SDL_RenderDrawLine(renderer, x + 10, budget_y, x + width - 10, budget_y);
+
+    length = snprintf(buffer, sizeof(buffer), "FRAME%26.2f%7.2f", frame_total / history_count, frame_max);
+    text->RenderText(buffer, length, x + 10, graph_y + 10, 8, {255, 255, 0, 255}, 1);
+
+    // what the levels hold in their arenas.
+    ArenaStats arenas = Arena::Totals();
+    length = snprintf(buffer, sizeof(buffer), "ARENAS %zuKB USED OF %zuKB IN %d BLOCKS", arenas.used / 1024, arenas.capacity / 1024,
+                      arenas.blocks);
+    text->RenderText(buffer, length, x + 10, graph_y + 10 + line, 8, {255, 255, 255, 255}, 1);
+
+    // what the whole program allocates, per frame on average, and what is left on the heap.
+    if (Allocations::Tracking()){
+        AllocationStats heap = Allocations::Totals();
+        length = snprintf(buffer, sizeof(buffer), "HEAP %lldKB LIVE, %.1f ALLOCS %.1fKB PER FRAME",
+                          (long long)(heap.live_bytes / 1024), double(allocations) / history_count, bytes / 1024.0 / history_count);
+    }
+    else {
+        length = snprintf(buffer, sizeof(buffer), "HEAP NOT TRACKED");
+    }
+    text->RenderText(buffer, length, x + 10, graph_y + 10 + 2 * line, 8, {255, 255, 255, 255}, 1);
+}
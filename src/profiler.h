@@ -0,0 +1,84 @@
+#pragma once
+#include "headers.h"
+#include "text.h"
+#include "trace.h"
+#include "allocations.h"
+
+/*
+    Scoped timing zones to see where a frame goes. PROFILE_ZONE("name") at the top of a block times the rest of
+    the block, and the overlay (F3) shows the rolling average and maximum time per frame for every zone.
+    In a build that tracks allocations it also shows how often every zone allocates, and how much the whole frame does.
+    While a trace is being captured the zones are also recorded into it.
+    The zones are only compiled in when SPACE_INVERSION_PROFILING is defined, otherwise the macro is empty.
+*/
+#ifdef SPACE_INVERSION_PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) \
+    static int PROFILE_CONCAT(profile_zone_, __LINE__) = profiler.Register(name); \
+    ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(PROFILE_CONCAT(profile_zone_, __LINE__), name)
+#else
+#define PROFILE_ZONE(name)
+#endif
+
+struct ProfileZone {
+    static const int HISTORY = 120;
+
+    const char * name = "";
+    // time spent in the zone since the last frame ended, zones can be hit from both threads.
+    atomic<Uint64> current_ns{0};
+    atomic<Uint64> current_allocations{0};
+    // time spent in the zone and allocations made in it in each of the last frames.
+    Uint64 history[HISTORY] = {};
+    Uint64 allocation_history[HISTORY] = {};
+};
+
+class Profiler {
+    private:
+        static const int MAX_ZONES = 32;
+
+        mutex lock;
+        ProfileZone zones[MAX_ZONES];
+        atomic<int> zone_count{0};
+        double frequency;
+
+        // frame times in milliseconds for the graph.
+        double frame_times[ProfileZone::HISTORY] = {};
+        // allocations and bytes allocated by all threads in each frame.
+        Uint64 frame_allocations[ProfileZone::HISTORY] = {};
+        Uint64 frame_bytes[ProfileZone::HISTORY] = {};
+        AllocationStats last_allocations;
+        int history_index = 0;
+        int history_count = 0;
+
+    public:
+        bool visible = false;
+
+        Profiler();
+        int Register(const char * name);
+        void Add(int zone, Uint64 start, Uint64 end, Uint64 allocations);
+        void EndFrame(double frame_ms);
+        void Render(SDL_Renderer * renderer, TextCache * text, int x, int y);
+};
+
+extern Profiler profiler;
+
+class ProfileScope {
+    private:
+        int zone;
+        const char * name;
+        Uint64 start;
+        Uint64 allocations;
+    public:
+        ProfileScope(int zone, const char * name){
+            this->zone = zone;
+            this->name = name;
+            allocations = Allocations::Thread().allocations;
+            start = SDL_GetPerformanceCounter();
+        }
+        ~ProfileScope(){
+            Uint64 end = SDL_GetPerformanceCounter();
+            profiler.Add(zone, start, end, Allocations::Thread().allocations - allocations);
+            tracer.Zone(name, start, end);
+        }
+};
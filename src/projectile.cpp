@@ -1,73 +1,200 @@
 #include "projectile.h"
+#include "collision.h"
 #include "math.h"
 
-Projectile::Projectile(SpriteCache * cache,int x, int y, int w, int h, float a, SDL_Color color, int speed){
+Projectile::Projectile(SpriteCache * cache, int clip, int x, int y, int w, int h, float a, SDL_Color color, int speed){
     this->cache = cache;
-    renderer = cache->renderer;
+    this->clip = clip;
     x_pos = x;
     y_pos = y;
+    last_x = x;
+    last_y = y;
     width = w;
     height = h;
     angle = a * (PI / 180);
 
     this->speed = speed;
     this->color = color;
+    velocity_x = cos(angle) * (speed * 100);
+    velocity_y = -sin(angle) * (speed * 100);
 
     hitbox.x = x_pos;
     hitbox.y = y_pos;
     hitbox.h = height;
     hitbox.w = width;
-    
-    sprites["DEFAULT"] = new Sprite(cache, {0, 0, 25, 25}, hitbox, "resources/blast.bmp");
+
+    cache->Play(&playhead, clip);
 }
 
-void Projectile::Process(Clock * clock){
-    x_pos += (cos(angle)*(speed * 100)) * clock->delta_time_s;
-    y_pos += (-sin(angle)*(speed * 100)) * clock->delta_time_s;
-    sprites["DEFAULT"]->Animate(clock);
+int Projectile::Clip(SpriteCache * cache){
+    return cache->AddClip("resources/blast.bmp", {0, 0, 25, 25});
 }
 
+void Projectile::Process(Clock * clock){
+    last_x = x_pos;
+    last_y = y_pos;
+    x_pos += velocity_x * clock->delta_time_s;
+    y_pos += velocity_y * clock->delta_time_s;
+    cache->Advance(&playhead, 1, clock->delta_time_s);
+    UpdateRect();
+}
 
-void Projectile::Render(){
+void Projectile::UpdateRect(){
     hitbox.x = (x_pos - int(hitbox.w/2));
     hitbox.y = (y_pos - int(hitbox.h/2));
-    hitbox.w = sprites["DEFAULT"]->d_rect.w;
-    hitbox.h = sprites["DEFAULT"]->d_rect.h;
+    hitbox.w = width;
+    hitbox.h = height;
+}
 
-    // SDL_SetRenderDrawColor(renderer,color.r, color.g, color.b, color.a);
-    // SDL_RenderFillRect(renderer,&hitbox);
-    sprites["DEFAULT"]->SetPos(x_pos,y_pos);
-    sprites["DEFAULT"]->Render();
+void Projectile::Render(RenderSnapshot * snapshot){
+    // snapshot->AddRect(color, hitbox.w, hitbox.h, x_pos, y_pos, last_x, last_y);
+    cache->RenderClip(snapshot, clip, &playhead, width, height, int(x_pos), int(y_pos), last_x, last_y, sprite_angle);
 }
 
 bool Projectile::IsTouchingRect(SDL_Rect * rect){
     return SDL_HasIntersection(&hitbox, rect);
 }
 
-Projectile::~Projectile(){
-    for (auto const sprite: sprites){
-        delete sprite.second;
+SDL_Rect Projectile::LastRect(){
+    // the hitbox moved back by as much as it moved this tick, rounded the way UpdateRect rounds it. A projectile that
+    // was just fired hasn't moved, so its last rect is its hitbox.
+    SDL_Rect rect = hitbox;
+    rect.x -= int(x_pos - int(hitbox.w / 2)) - int(last_x - int(hitbox.w / 2));
+    rect.y -= int(y_pos - int(hitbox.h / 2)) - int(last_y - int(hitbox.h / 2));
+    return rect;
+}
+
+SDL_Rect Projectile::SweptRect(){
+    SDL_Rect last = LastRect();
+    SDL_Rect swept;
+    swept.x = min(last.x, hitbox.x);
+    swept.y = min(last.y, hitbox.y);
+    swept.w = max(last.x + last.w, hitbox.x + hitbox.w) - swept.x;
+    swept.h = max(last.y + last.h, hitbox.y + hitbox.h) - swept.y;
+    return swept;
+}
+
+bool Projectile::Sweep(const SDL_Rect * rect, double * time){
+    SDL_Rect last = LastRect();
+    return SweepRect(last, hitbox.x - last.x, hitbox.y - last.y, *rect, time);
+}
+
+Missile::Missile(SpriteCache * cache, int clip, int x, int y, int w, int h, float angle, SDL_Color color, int speed) 
+    : Projectile(cache, clip, x, y, w, h, angle, color, speed){}
+
+int Missile::Clip(SpriteCache * cache){
+    return cache->AddClip("resources/missle.bmp", {0, 0, 20, 20}, 20, 3, .1);
+}
+
+Blaster::Blaster(SpriteCache * cache, int clip, int x, int y, int w, int h, float angle, SDL_Color color, int speed) 
+    : Projectile(cache, clip, x, y, w, h, angle, color, speed){}
+
+int Blaster::Clip(SpriteCache * cache){
+    return cache->AddClip("resources/blaster.bmp", {0, 0, 6, 6}, 6, 2, .06, 0, SDL_FLIP_VERTICAL);
+}
+
+Laser::Laser(SpriteCache * cache, int clip, int x, int y, int w, int h, float angle, SDL_Color color, int speed) 
+    : Projectile(cache, clip, x, y, w, h, angle, color, speed){}
+
+int Laser::Clip(SpriteCache * cache){
+    return cache->AddClip("resources/laser.bmp", {0, 0, 6, 6}, 6, 2, .06);
+}
+
+Laser2::Laser2(SpriteCache * cache, int clip, int x, int y, int w, int h, float angle, SDL_Color color, int speed) 
+    : Projectile(cache, clip, x, y, w, h, angle, color, speed){
+    // the laser is drawn pointing the way it flies.
+    sprite_angle = -(angle - double(270));
+}
+
+int Laser2::Clip(SpriteCache * cache){
+    return cache->AddClip("resources/laser2.bmp", {0, 0, 6, 6}, 6, 2, .06, 0, SDL_FLIP_VERTICAL);
+}
+
+
+ProjectilePool::ProjectilePool(Arena * arena)
+: projectiles(arena), slots(arena), indices(arena), generations(arena), free_slots(arena) {}
+
+void ProjectilePool::Reserve(int capacity){
+    // only done while nothing is flying, the projectiles array must not move while it is being walked.
+    // the arrays grow by at least double, so reserving for one shooter at a time doesn't copy them every time.
+    if (capacity > int(projectiles.capacity())){
+        int grown = max(capacity, int(projectiles.capacity()) * 2);
+        projectiles.reserve(grown);
+        slots.reserve(grown);
+        free_slots.reserve(grown);
+    }
+    indices.resize(capacity, -1);
+    generations.resize(capacity, 0);
+    for (int slot = capacity - 1; slot >= this->capacity; slot--){
+        free_slots.push_back(slot);
+    }
+    this->capacity = capacity;
+}
+
+int ProjectilePool::Capacity(){
+    return capacity;
+}
+
+int ProjectilePool::Size(){
+    return projectiles.size();
+}
+
+ProjectileHandle ProjectilePool::Fire(const Projectile &projectile){
+    if (free_slots.empty()){
+        return {};
+    }
+    int slot = free_slots.back();
+    free_slots.pop_back();
+
+    indices[slot] = projectiles.size();
+    slots.push_back(slot);
+    projectiles.push_back(projectile);
+    return {slot, generations[slot]};
+}
+
+Projectile & ProjectilePool::At(int index){
+    return projectiles[index];
+}
+
+Projectile * ProjectilePool::Get(ProjectileHandle handle){
+    if (handle.slot < 0 || generations[handle.slot] != handle.generation){
+        return nullptr;
     }
-    sprites.clear();
+    return &projectiles[indices[handle.slot]];
+}
+
+ProjectileHandle ProjectilePool::Handle(int index){
+    return {slots[index], generations[slots[index]]};
 }
 
-Missile::Missile(SpriteCache * cache,int x, int y, int w, int h, float angle, SDL_Color color, int speed) 
-    : Projectile(cache, x, y, w, h, angle, color, speed){
-    sprites["DEFAULT"] = new AnimatedSprite(cache, {0, 0, 20, 20}, hitbox, "resources/missle.bmp", 20, 3, .1);
+void ProjectilePool::Retire(int index){
+    int slot = slots[index];
+    int last = projectiles.size() - 1;
+
+    // the last projectile takes the place of the retired one.
+    if (index != last){
+        projectiles[index] = projectiles[last];
+        slots[index] = slots[last];
+        indices[slots[index]] = index;
+    }
+    projectiles.pop_back();
+    slots.pop_back();
+
+    indices[slot] = -1;
+    generations[slot]++;
+    free_slots.push_back(slot);
 }
 
-Blaster::Blaster(SpriteCache * cache,int x, int y, int w, int h, float angle, SDL_Color color, int speed) 
-    : Projectile(cache, x, y, w, h, angle, color, speed){
-    sprites["DEFAULT"] = new AnimatedSprite(cache, {0, 0, 6, 6}, hitbox, "resources/blaster.bmp", 6, 2, .06, 0, SDL_FLIP_VERTICAL);
+void ProjectilePool::Clear(){
+    while (Size()){
+        Retire(Size() - 1);
+    }
 }
 
-Laser::Laser(SpriteCache * cache,int x, int y, int w, int h, float angle, SDL_Color color, int speed) 
-    : Projectile(cache, x, y, w, h, angle, color, speed){
-    sprites["DEFAULT"] = new AnimatedSprite(cache, {0, 0, 6, 6}, hitbox, "resources/laser.bmp", 6, 2, .06);
+ArenaVector<Projectile>::iterator ProjectilePool::begin(){
+    return projectiles.begin();
 }
 
-Laser2::Laser2(SpriteCache * cache, int x, int y, int w, int h, float angle, SDL_Color color, int speed) 
-    : Projectile(cache, x, y, w, h, angle, color, speed){
-    angle = -(angle - double(270));
-    sprites["DEFAULT"] = new AnimatedSprite(cache, {0, 0, 6, 6}, hitbox,"resources/laser2.bmp", 6, 2, .06, angle, SDL_FLIP_VERTICAL);
-}
\ No newline at end of file
+ArenaVector<Projectile>::iterator ProjectilePool::end(){
+    return projectiles.end();
+}
@@ -1,47 +1,111 @@
 #pragma once
 #include "headers.h"
 #include "sprites.h"
+#include "arena.h"
 #define PI 3.1415926
 
+/*
+    Every kind of projectile plays its own clip. The shooter looks the clip up once with the Clip function
+    of the kind it shoots, and hands it to every projectile it fires.
+    The kinds only differ in how they are made, so a ProjectilePool keeps all of them as plain Projectiles.
+*/
 class Projectile{
     protected:
-        SDL_Renderer * renderer;
         SpriteCache * cache;
         int width, height;
         SDL_Color color;
         Clock * clock;
+        int clip;
+        Playhead playhead;
+        double sprite_angle = 0;
     public:
         double x_pos, y_pos;
+        double last_x, last_y;
         SDL_Rect hitbox;
+        // a projectile that hit something is taken out of its pool at the end of the tick.
         bool hit = false;
         float angle;
         int speed;
-        map<string, Sprite *> sprites;
+        // worked out from the angle and speed once, when it is fired.
+        double velocity_x, velocity_y;
+        // who fired it, as an index the shooter understands.
+        int owner = -1;
 
-        Projectile(SpriteCache *,int x, int y, int w, int h, float angle, SDL_Color, int speed);
-        virtual ~Projectile();
-        virtual void Process(Clock *);
-        virtual void Render();
+        Projectile(SpriteCache *, int clip, int x, int y, int w, int h, float angle, SDL_Color, int speed);
+        void Process(Clock *);
+        void Render(RenderSnapshot * snapshot);
+        void UpdateRect();
         bool IsTouchingRect(SDL_Rect *);
+        // the hitbox where the projectile was at the start of the tick, and the rect it swept over during the tick.
+        SDL_Rect LastRect();
+        SDL_Rect SweptRect();
+        // whether the projectile went through rect during the tick, and when it first touched it.
+        bool Sweep(const SDL_Rect * rect, double * time);
+        static int Clip(SpriteCache *);
         
 };
 
 class Missile : public Projectile{
     public:
-        Missile(SpriteCache *, int x, int y, int w, int h, float angle, SDL_Color, int speed);
+        Missile(SpriteCache *, int clip, int x, int y, int w, int h, float angle, SDL_Color, int speed);
+        static int Clip(SpriteCache *);
 };
 
 class Blaster : public Projectile{
     public:
-        Blaster(SpriteCache *, int x, int y, int w, int h, float angle, SDL_Color, int speed);
+        Blaster(SpriteCache *, int clip, int x, int y, int w, int h, float angle, SDL_Color, int speed);
+        static int Clip(SpriteCache *);
 };
 
 class Laser : public Projectile{
     public:
-        Laser(SpriteCache *, int x, int y, int w, int h, float angle, SDL_Color, int speed);
+        Laser(SpriteCache *, int clip, int x, int y, int w, int h, float angle, SDL_Color, int speed);
+        static int Clip(SpriteCache *);
 };
 
 class Laser2 : public Projectile {
     public:
-        Laser2(SpriteCache *, int x, int y, int w, int h, float angle, SDL_Color, int speed);
-};
\ No newline at end of file
+        Laser2(SpriteCache *, int clip, int x, int y, int w, int h, float angle, SDL_Color, int speed);
+        static int Clip(SpriteCache *);
+};
+
+
+// Stays pointing at the projectile it was given for while the projectile flies, even as the pool moves it around.
+struct ProjectileHandle {
+    int slot = -1;
+    int generation = 0;
+};
+
+/*
+    A fixed number of projectiles, reserved when the shooters are made. The live projectiles are packed at the
+    front of one array, so they are walked without gaps, and a retired one is replaced by the last one (swap-remove).
+    Every projectile also has a slot that doesn't move; a handle names the slot, and the generation of the slot
+    goes up every time its projectile is retired, so an old handle finds nothing instead of a new projectile.
+    Firing and retiring never allocate, a full pool doesn't fire. A pool given an arena keeps its arrays in it.
+*/
+class ProjectilePool {
+    private:
+        int capacity = 0;
+        ArenaVector<Projectile> projectiles;
+        // the slot of every live projectile, and where every slot's projectile is in the array.
+        ArenaVector<int> slots;
+        ArenaVector<int> indices;
+        ArenaVector<int> generations;
+        ArenaVector<int> free_slots;
+
+    public:
+        ProjectilePool(Arena * arena = nullptr);
+        void Reserve(int capacity);
+        int Capacity();
+        int Size();
+
+        ProjectileHandle Fire(const Projectile &projectile);
+        Projectile & At(int index);
+        Projectile * Get(ProjectileHandle handle);
+        ProjectileHandle Handle(int index);
+        void Retire(int index);
+        void Clear();
+
+        ArenaVector<Projectile>::iterator begin();
+        ArenaVector<Projectile>::iterator end();
+};
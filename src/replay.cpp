@@ -0,0 +1,128 @@
+#include "replay.h"
+#include "functions.h"
+#include <climits>
+
+Replay::Replay(){}
+
+Replay::Replay(string level_path, unsigned int seed, double tick_rate){
+    this->level_path = level_path;
+    this->seed = seed;
+    this->tick_rate = tick_rate;
+}
+
+void Replay::Record(PlayerInput * input){
+    inputs.push_back(Pack(input));
+}
+
+PlayerInput Replay::GetInput(size_t tick){
+    if (tick < inputs.size()){
+        return Unpack(inputs[tick]);
+    }
+    return PlayerInput();
+}
+
+bool Replay::Load(string path){
+    ifstream replay_file(path.c_str());
+    if (!replay_file.is_open()){
+        return false;
+    }
+
+    inputs.clear();
+    level_path = "";
+    string line;
+    while (getline(replay_file, line)){
+        vector<string> section = split(line, '|');
+        if (section.size() < 2){
+            continue;
+        }
+
+        if (section[0] == "*"){
+            vector<string> subsect = split(section[1], ':');
+            if (subsect.size() < 2){
+                return false;
+            }
+            if (subsect[0] == "level"){
+                level_path = subsect[1];
+            }
+            else if (subsect[0] == "seed"){
+                long long value;
+                if (!ParseInteger(subsect[1], 0, UINT_MAX, &value)){
+                    return false;
+                }
+                seed = (unsigned int)value;
+            }
+            else if (subsect[0] == "tick_rate"){
+                char * end = nullptr;
+                tick_rate = strtod(subsect[1].c_str(), &end);
+                if (end == subsect[1].c_str() || *end != '\0' || !(tick_rate > 0 && tick_rate <= MAX_TICK_RATE)){
+                    return false;
+                }
+            }
+        }
+        else if (section[0] == "+"){
+            for (auto run: split(section[1], ',')){
+                vector<string> count_buttons = split(run, '-');
+                long long count, buttons;
+                if (count_buttons.size() != 2 || !ParseInteger(count_buttons[0], 1, MAX_TICKS - inputs.size(), &count)
+                    || !ParseInteger(count_buttons[1], 0, 255, &buttons)){
+                    return false;
+                }
+                inputs.insert(inputs.end(), size_t(count), Uint8(buttons));
+            }
+        }
+    }
+    replay_file.close();
+    return level_path != "";
+}
+
+bool Replay::Save(string path){
+    ofstream replay_file(path.c_str());
+    if (!replay_file.is_open()){
+        return false;
+    }
+
+    replay_file << "*|level:" << level_path << ":" << endl;
+    replay_file << "*|seed:" << seed << ":" << endl;
+    replay_file << "*|tick_rate:" << tick_rate << ":" << endl;
+
+    // the input is written as runs, 16 runs per line.
+    size_t i = 0;
+    int runs = 0;
+    while (i < inputs.size()){
+        size_t count = 1;
+        while (i + count < inputs.size() && inputs[i + count] == inputs[i]){
+            count++;
+        }
+        if (runs % 16 == 0){
+            replay_file << (runs ? "\n+|" : "+|");
+        }
+        replay_file << count << "-" << int(inputs[i]) << ",";
+        runs++;
+        i += count;
+    }
+    replay_file << endl;
+    replay_file.close();
+    return true;
+}
+
+Uint8 Replay::Pack(PlayerInput * input){
+    Uint8 buttons = 0;
+    if (input->left){buttons |= LEFT;}
+    if (input->right){buttons |= RIGHT;}
+    if (input->fire){buttons |= FIRE;}
+    if (input->pause){buttons |= PAUSE;}
+    if (input->restart){buttons |= RESTART;}
+    if (input->quit){buttons |= QUIT;}
+    return buttons;
+}
+
+PlayerInput Replay::Unpack(Uint8 buttons){
+    PlayerInput input;
+    input.left = buttons & LEFT;
+    input.right = buttons & RIGHT;
+    input.fire = buttons & FIRE;
+    input.pause = buttons & PAUSE;
+    input.restart = buttons & RESTART;
+    input.quit = buttons & QUIT;
+    return input;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+#include "headers.h"
+#include "input.h"
+
+/*
+    A replay is everything needed to play a level again exactly the way it was played: the level file,
+    the seed of the level's random generator, the tick rate and the input of every tick.
+
+    Replays are saved in the same style as the level files:
+        *|level:resources/levels/level.mx:
+        *|seed:1234:
+        *|tick_rate:120:
+        +|90-0,12-4,30-1,
+    where every "+" entry is a run of ticks with the same input, written as count-buttons.
+*/
+class Replay {
+    public:
+        // bits used to pack the input of a tick into a single byte.
+        static const Uint8 LEFT = 1, RIGHT = 2, FIRE = 4, PAUSE = 8, RESTART = 16, QUIT = 32;
+        // a replay longer than this (an hour at 1000 ticks per second) isn't loaded, and neither is a faster one.
+        static const size_t MAX_TICKS = 3600000;
+        static constexpr double MAX_TICK_RATE = 1000.0;
+
+        string level_path = "";
+        unsigned int seed = 0;
+        double tick_rate = 120.0;
+        vector<Uint8> inputs;
+
+        Replay();
+        Replay(string level_path, unsigned int seed, double tick_rate);
+
+        void Record(PlayerInput * input);
+        PlayerInput GetInput(size_t tick);
+        // false if the file can't be read, has no level or has a field that isn't what Save writes.
+        bool Load(string path);
+        bool Save(string path);
+
+        static Uint8 Pack(PlayerInput * input);
+        static PlayerInput Unpack(Uint8 buttons);
+};
\ No newline at end of file
@@ -1,46 +1,63 @@
 #include "scene.h"
-
-LevelScene::LevelScene(SDL_Renderer * r, Framebuffer * framebuffer, SpriteCache * sprite_cache, TextCache * text_cache, SDL_RendererFlip * flip){
-    this->framebuffer = framebuffer;
-    countdown_sprite = new AnimatedSprite(sprite_cache, {-128, 0, 128, 128}, {400, 300, 200, 200}, "resources/countdown.bmp", 128, 5, .4);
-    this->hud = new Hud(sprite_cache, framebuffer, player, text_cache);
-    starting = true;
-    running = false;
-    finished = false;
-    paused = false;
-    renderer = r;
+#include "profiler.h"
+
+LevelScene::LevelScene(SpriteCache * sprite_cache, SDL_RendererFlip * flip)
+: stars_l1(&arena), stars_l2(&arena), bullet_hits(&arena), first_impact(&arena) {
+    countdown_sprite = arena.New<AnimatedSprite>(sprite_cache, SDL_Rect{-128, 0, 128, 128}, SDL_Rect{400, 300, 200, 200},
+                                                "resources/countdown.bmp", 128, 5, .4);
+    this->hud = arena.New<Hud>(sprite_cache, player);
+    enemies = arena.New<EnemyStore>(&arena, sprite_cache);
+    fleet = arena.New<Fleet>(&arena);
+    collisions = arena.New<CollisionGrid>(&arena);
+    events = arena.New<CollisionEvents>(&arena);
     shot_interval = 1;
     this->flip = flip;
     filling_stars = true;
-    text_renderer = text_cache;
 
 }
 
-void LevelScene::AddEnemy(Enemy * enemy){
-    enemies.push_back(enemy);
+void LevelScene::AddEnemy(EnemyKind kind, int x, int y, int w, int h){
+    enemies->Add(kind, x, y, w, h);
+    fleet->Add(x, y, w, enemy_kinds[kind].speed);
 }
 
-void LevelScene::AddPlayer(Player * p){
+void LevelScene::AddPlayer(Player * p, int x, int y, int w, int h){
     player = p;
+    player_spawn = {x, y, w, h};
     hud->player = p;
+    enemies->player = p;
 }
 
-void LevelScene::Process(Clock * clock, KeyboardManager * keyboard, MouseManager * mouse, ControllerManager * controllers, Jukebox * jukebox, string * state,  int width, int height){
-    if (starting){
+void LevelScene::Process(Clock * clock, PlayerInput * input, ControllerManager * controllers, Jukebox * jukebox, GameState * state,  int width, int height){
+    PROFILE_ZONE("LevelScene::Process");
+    if (scene_state == SCENE_STARTING){
         // This is here in case we need to set individual player state based on stuff.
         
         // below we are creating random stars to populate the level, using different layering.
+        // a level that is played again puts the stars it has in new places.
         if (filling_stars){
             for (int i=0; i < 9; i++){
-                int random_x = rand() % (width - 5) + 10;
-                int random_y = rand() % (height - 5) + 10;
-                stars_l1.push_back(new Bullet(renderer, random_x, random_y, 5, 5, {255, 255, 255, 255}));
+                int random_x = rng() % (width - 5) + 10;
+                int random_y = rng() % (height - 5) + 10;
+                Bullet star(random_x, random_y, 5, 5, {255, 255, 255, 255});
+                if (i < int(stars_l1.size())){
+                    *stars_l1[i] = star;
+                }
+                else {
+                    stars_l1.push_back(arena.New<Bullet>(star));
+                }
             }
 
             for (int i=0; i < 5; i++){
-                int random_x = rand() % (width - 5) + 10;
-                int random_y = rand() % (height - 5) + 10;
-                stars_l2.push_back(new Bullet(renderer, random_x, random_y, 5, 5, {255, 255, 255, 255}));
+                int random_x = rng() % (width - 5) + 10;
+                int random_y = rng() % (height - 5) + 10;
+                Bullet star(random_x, random_y, 5, 5, {255, 255, 255, 255});
+                if (i < int(stars_l2.size())){
+                    *stars_l2[i] = star;
+                }
+                else {
+                    stars_l2.push_back(arena.New<Bullet>(star));
+                }
             }
             filling_stars = false;
         }
@@ -63,41 +80,42 @@ void LevelScene::Process(Clock * clock, KeyboardManager * keyboard, MouseManager
         if (countdown_sprite->finished){
             jukebox->PlayMusic("stage_music");
             countdown_sprite->Reset();
-            running = true;
+            scene_state = scene_transitions[scene_state][SCENE_COUNTED_DOWN];
             countdown_n = 4;
-            starting = false;
             countdown = 0.0;
         }
 
     }
 
-    if (running){
+    if (scene_state != SCENE_STARTING){
 
         if (player->lives <= 0){
-            options = true;
+            scene_state = scene_transitions[scene_state][SCENE_OUT_OF_LIVES];
+        }
+        else if (enemies_dead == enemies->count){
+            scene_state = scene_transitions[scene_state][SCENE_ENEMIES_CLEARED];
         }
         
-        if (options){
+        if (scene_state == SCENE_LOST){
 
             if (*flip == SDL_FLIP_VERTICAL){
                 *flip = SDL_FLIP_NONE;
                 jukebox->PlaySoundEffect("inversion");
             }
 
-            if (keyboard->KeyWasPressed(SDL_GetScancodeFromKey(SDLK_q)) || controllers->GetControllerButtonWasPressed(0, "X")){
-                *state = "MENU";
+            if (input->quit){
+                *state = game_transitions[*state][GAME_LEVEL_LEFT];
                 jukebox->StopMusic();
                 jukebox->StopSoundEffects();
                 jukebox->PlayMusic("title_theme");
             }
 
-            if (keyboard->KeyWasPressed(SDL_GetScancodeFromKey(SDLK_r)) || controllers->GetControllerButtonWasPressed(0, "A")){
+            if (input->restart){
                 Reset(jukebox);
             }
         }
 
-        else if (enemies_dead == int(enemies.size())){
-            winner = true;
+        else if (scene_state == SCENE_WON){
             time_left += clock->delta_time_s;
 
             if (*flip == SDL_FLIP_VERTICAL){
@@ -106,14 +124,14 @@ void LevelScene::Process(Clock * clock, KeyboardManager * keyboard, MouseManager
             }
 
             if (time_left >= 5){
-                *state = "MENU";
+                *state = game_transitions[*state][GAME_LEVEL_LEFT];
                 jukebox->StopMusic();
                 jukebox->StopSoundEffects();
                 jukebox->PlayMusic("title_theme");
             }
         }
 
-        if (keyboard->KeyWasPressed(SDL_SCANCODE_P) || controllers->GetControllerButtonWasPressed(0, "START")){
+        if (input->pause){
             if (paused){
                 paused = false;
                 jukebox->ResumeMusic();
@@ -128,17 +146,17 @@ void LevelScene::Process(Clock * clock, KeyboardManager * keyboard, MouseManager
         
         if (!paused){
             // Managing movement for player
-            if (keyboard->KeyIsPressed(SDL_SCANCODE_A) || controllers->GetControllerButtonPressed(0, "LEFT")){
-                player->Move("left");
+            if (input->left){
+                player->Move(DIRECTION_LEFT);
             }
-            else if (keyboard->KeyIsPressed(SDL_SCANCODE_D) || controllers->GetControllerButtonPressed(0, "RIGHT")) {
-                player->Move("right");
+            else if (input->right) {
+                player->Move(DIRECTION_RIGHT);
             }
             else {
-                player->Move("none");
+                player->Move(DIRECTION_NONE);
             }
 
-            if (keyboard->KeyIsPressed(SDL_SCANCODE_SPACE) || controllers->GetControllerButtonPressed(0, "X")) {
+            if (input->fire) {
                 if (player->Attack()){
                     jukebox->PlaySoundEffect("blast");
                     controllers->SetControllerRumble(0, 20, 0, .3);
@@ -147,11 +165,11 @@ void LevelScene::Process(Clock * clock, KeyboardManager * keyboard, MouseManager
 
             // make sure the player can't move outta bounds.
             if (player->d_rect.x < -1){
-                player->Move("none");
+                player->Move(DIRECTION_NONE);
                 player->x_pos += 1;
             }
             else if (player->d_rect.x > width - (player->d_rect.w - 1)){
-                player->Move("none");
+                player->Move(DIRECTION_NONE);
                 player->x_pos -= 1;
             }
 
@@ -159,17 +177,28 @@ void LevelScene::Process(Clock * clock, KeyboardManager * keyboard, MouseManager
             player->Process(clock);
             ManageEnemies(clock, controllers, jukebox, width, height);
 
-            // Move the stars.
+            #ifdef SPACE_INVERSION_PROFILING
+            if (tracer.recording){
+                TRACE_COUNTER("live projectiles", player->bullets.Size() + enemies->bullets.Size());
+                TRACE_COUNTER("live enemies", enemies->count - enemies_dead);
+            }
+            #endif
+
+            // Move the stars, the last position is wrapped along with the star so it doesn't streak across the screen.
             for (auto star: stars_l1){
+                star->last_y = star->y_pos;
                 star->y_pos += (3 * 100) * clock->delta_time_s;
                 if (star->y_pos >= height){
                     star->y_pos = star->y_pos - height;
+                    star->last_y = star->last_y - height;
                 }
             }
             for (auto star: stars_l2){
+                star->last_y = star->y_pos;
                 star->y_pos += (3 * 100) * clock->delta_time_s;
                 if (star->y_pos >= height){
                     star->y_pos = star->y_pos - height;
+                    star->last_y = star->last_y - height;
                 }
             }
         }
@@ -180,262 +209,383 @@ void LevelScene::Process(Clock * clock, KeyboardManager * keyboard, MouseManager
 // This method handles all of the specific interactions between enemies (of different types), and the player, as well
 // as that's important for interactions.
 void LevelScene::ManageEnemies(Clock * clock, ControllerManager * controllers, Jukebox * jukebox, int width, int height){
-    if (enemy_state == "PHASE_DOWN"){
-        countdown += clock->delta_time_s;
-    }
-
+    PROFILE_ZONE("ManageEnemies");
     shoot_timer += clock->delta_time_s;
 
-    int random_index = 0;
-    if (enemies.size()){
-        random_index = rand() % enemies.size();
+    // an enemy counts as soon as it is hit, before its explosion has played. The score goes up with the events.
+    enemies_dead = enemies->destroyed;
+
+    // The fleet decides where all of the enemies go this tick, they stop while the player is dying. One of the
+    // bottom-most enemies of the columns shoots at the player.
+    Direction heading = DIRECTION_NONE;
+    bool player_is_dying = (player->state == PLAYER_DYING) || (player->state == PLAYER_RESPAWNING);
+    if (!player_is_dying){
+        heading = fleet->March(width, clock->delta_time_s);
+        if (shoot_timer >= shot_interval){
+            int shooter = fleet->PickShooter(rng);
+            if (shooter >= 0 && enemies->Attack(enemies->slot[shooter])){
+                jukebox->PlaySoundEffect("blast");
+            }
+        }
+    }
+    fleet->Advance(heading, clock->delta_time_s);
+
+    // The player and its bullets go into the grid once, then every enemy only tests what is in the cells it covers:
+    // the player bullets against the enemy, and the enemy against the player. Nothing in the grid moves until the
+    // enemies are processed.
+    // A bullet is in the grid with all of the rect it swept over this tick, and is tested from where it was to where
+    // it is, so a long tick can't carry it through an enemy without hitting it.
+    collisions->Begin(width, height);
+    collisions->Add(LAYER_PLAYER, 0, player->d_rect);
+    for (int b = 0; b < player->bullets.Size(); b++){
+        collisions->Add(LAYER_PLAYER_BULLET, b, player->bullets.At(b).SweptRect());
     }
 
-    enemies_dead = 0;
-    for (int i = 0; i < enemies.size();i++){
-        /*
-        "DYING" state is captured quicker than dead boolean or dead state
-        (as enemy plays dying animation before the dead boolean is set),
-        allowing the score to be set immediately upon the enemy dying
-        */ 
-        if (enemies[i]->state == "DYING" || enemies[i]->state == "DEAD"){
-            enemies_dead++;
+    // A bullet only hits the enemy it reaches first, and not the ones behind it that it would have reached later in
+    // the tick; enemies it reaches at the same time are all hit. Explosions don't stop bullets.
+    bullet_hits.clear();
+    first_impact.assign(player->bullets.Size(), 2.0);
+    for (int i = 0; i < enemies->active; i++){
+        if (enemies->state[i] == ENEMY_DYING){
+            continue;
         }
+        SDL_Rect * rect = &enemies->rects[i];
+        collisions->Query(LAYER_PLAYER_BULLET, *rect, [&](int b){
+            // the rects first, then the pixels of the enemy against all the bullet went over. An enemy made of parts
+            // is hit by the part the bullet reaches first instead.
+            double time;
+            int part = -1;
+            Projectile &bullet = player->bullets.At(b);
+            bool hit = enemies->Compound(i) ? enemies->SweepParts(i, bullet, &time, &part)
+                                            : bullet.Sweep(rect, &time) && enemies->Touches(i, bullet.SweptRect());
+            if (hit){
+                bullet_hits.push_back({i, b, time, part});
+                first_impact[b] = min(first_impact[b], time);
+            }
+        });
     }
+    int next_hit = 0;
 
-    hud->SetScore(enemies_dead * 200);
-
-    for (int i = 0; i < enemies.size(); i++){
+    // Then what happens to every enemy, one enemy at a time since each can hurt the player.
+    // Nothing decided here depends on where the other enemies move to, so they are all moved together afterwards.
+    // Only the enemies still in play are looked at, the dead ones are after them.
+    for (int i = 0; i < enemies->active; i++){
 
         //"player is dying" is used to check if the player is dying, so that events respond accordingly.
         //"player is dead" is used to check if the player died.
-        bool player_is_dying = (player->state == "DYING") || (player->state == "RESPAWNING");
-        
-        // Process the enemy as soon as it comes up.
+        player_is_dying = (player->state == PLAYER_DYING) || (player->state == PLAYER_RESPAWNING);
+        SDL_Rect * rect = &enemies->rects[i];
+        enemies->speed[i] = fleet->speed;
+        enemies->Move(i, heading);
+
         if (!player_is_dying) {
-            // select a random ship to shoot at the player.
-            if (!enemies[i]->dead){
-                if (shoot_timer >= shot_interval){
-                    if (i == random_index){
-                        if (enemies[i]->Attack()){
-                            jukebox->PlaySoundEffect("blast");
-                        }       
-                    }
+            enemies->Emit(i, clock->delta_time_s);
+
+            //check if the player collided with any of the enemies
+            bool touching_player = false;
+            collisions->Query(LAYER_PLAYER, *rect, [&](int){
+                touching_player = enemies->state[i] != ENEMY_DEFAULT || MasksOverlap(enemies->Mask(i), *rect, player->Mask(), player->d_rect);
+            });
+            if (touching_player && !player->dead){
+                if (enemies->state[i] != ENEMY_DYING){
+                    player->Hurt();
+                    events->Emit(EVENT_PLAYER_HURT, enemies->id[i]);
+                    events->Emit(EVENT_ENEMY_KILLED, enemies->id[i]);
                 }
+                enemies->Hit(i);
             }
+        }
 
-            if (!enemies[i]->dead){
-            double speed_multiplier = double(enemies_dead)/double((enemies.size()-1))*12;
-            enemies[i]->speed = int(speed_multiplier) + enemies[i]->default_speed;
+        // check if the enemy collided with any of the players bullets, the hits of every enemy are next to each other.
+        // A bullet is used up by an enemy that wasn't hit yet. A bullet that hits a part shoots it off, which only
+        // destroys the enemy when it was the core or the last part. A part comes off once however many bullets reach it.
+        bool shot = false;
+        for (; next_hit < int(bullet_hits.size()) && bullet_hits[next_hit].target == i; next_hit++){
+            CollisionHit &hit = bullet_hits[next_hit];
+            if (hit.time > first_impact[hit.projectile]){
+                continue;
             }
-
-            if (!enemies[i]->dead){
-                if (enemy_state == "PHASE_LEFT"){
-                    enemies[i]->Move("left");
-                    if (enemies[i]->d_rect.x <= 0){
-                        last_state = enemy_state;
-                        enemy_state = "PHASE_DOWN";
-                    } 
-                }
-                else if (enemy_state == "PHASE_RIGHT"){
-                    enemies[i]->Move("right");
-                    if (enemies[i]->d_rect.x >= width - enemies[i]->d_rect.w){
-                        last_state = enemy_state;
-                        enemy_state = "PHASE_DOWN";
-                    }
+            if (hit.part < 0){
+                if (enemies->state[i] != ENEMY_DYING){
+                    player->bullets.At(hit.projectile).hit = true;
+                    events->Emit(EVENT_ENEMY_HIT, enemies->id[i]);
                 }
-                if (enemy_state == "PHASE_DOWN"){
-                    enemies[i]->Move("down");
-                    if (countdown >= .2){
-                        if (last_state == "PHASE_LEFT"){
-                            enemy_state = "PHASE_RIGHT";
-                            countdown = 0.0;
-                        }
-                        else{
-                            enemy_state = "PHASE_LEFT";
-                            countdown = 0.0;
-                        }
-                    }
-                }     
+                shot = true;
             }
-            //check if the player collided with any of the enemies
-            if (player->TouchingEnemy(&enemies[i]->d_rect) && !player->dead){
-                if (enemies[i]->state != "DYING"){
-                    player->Hurt();
-                    controllers->SetControllerRumble(0, 0, 60, .3);
-                    jukebox->PlaySoundEffect("dying_p");
-                }
-                enemies[i]->state = "DYING";
-            }
-
-            // check if the player collided with any of the enemy bullets.
-            if (!player->dead){
-                int bullet_index = 0;
-                if (enemies[i]->TouchingBullet(&player->d_rect)){
-                    for (auto bullet: enemies[i]->bullets){
-                        if (bullet->IsTouchingRect(&player->d_rect)){
-                            /*
-                                TODO: only use this logic for basic pawn bullets. 
-                                differentiate when "projectile" class is created and used
-                                instead.
-                            */
-                            if (!bullet->hit){
-                                player->Hurt();
-                                controllers->SetControllerRumble(0, 0, 60, .3);
-                                jukebox->PlaySoundEffect("dying_p");
-                                if (*flip == SDL_FLIP_NONE){
-                                    *flip = SDL_FLIP_VERTICAL;
-                                } else {
-                                    *flip = SDL_FLIP_NONE;
-                                }
-                                jukebox->PlaySoundEffect("inversion");
-                            }
-                            bullet->hit = true;
-                            enemies[i]->erased.push_back(bullet_index);
-                        }
-                        bullet_index++;
-                    }
+            else if (enemies->state[i] != ENEMY_DYING){
+                player->bullets.At(hit.projectile).hit = true;
+                if (enemies->parts[i] >> hit.part & 1){
+                    events->Emit(EVENT_ENEMY_HIT, enemies->id[i], hit.part);
+                    shot = enemies->HitPart(i, hit.part) || shot;
                 }
-            }  
-        }
-        else {
-            enemies[i]->Move("none");
+            }
         }
-
-        // check if the enemy collided with any of the players bullets.
-        int index = 0;
-        if (player->TouchingBullet(&enemies[i]->d_rect)){
-            for (auto bullet: player->bullets){
-                if (enemies[i]->state != "DYING"){
-                    if (bullet->IsTouchingRect(&enemies[i]->d_rect)){
-                        if (!bullet->hit) {
-                            bullet->hit = true;
-                            player->erased.push_back(index); 
-                        }
-                    }
-                    jukebox->PlaySoundEffect("dying");
-                } 
-                index++;  
+        if (shot){
+            if (enemies->state[i] != ENEMY_DYING){
+                events->Emit(EVENT_ENEMY_KILLED, enemies->id[i]);
             }
-            enemies[i]->state = "DYING";   
+            enemies->Hit(i);
         }
+    }
 
-        //reset enemies to the top if they go off screen
-        if (enemies[i]-> y_pos >= 600){
-            enemies[i]->SetPos(enemies[i]->x_pos,0);
+    // check if the player collided with any of the enemy bullets, the bullets of all enemies are in one pool.
+    // They go into the grid after the enemies decided, so the ones fired this tick are in it too. They are swept
+    // like the player bullets, against where the player is at the end of the tick.
+    player_is_dying = (player->state == PLAYER_DYING) || (player->state == PLAYER_RESPAWNING);
+    if (!player_is_dying && !player->dead){
+        for (int b = 0; b < enemies->bullets.Size(); b++){
+            collisions->Add(LAYER_ENEMY_BULLET, b, enemies->bullets.At(b).SweptRect());
         }
-        enemies[i]->Process(clock, height);
+        // A player hit by many projectiles in one tick loses one life, the first hit sends the player into dying.
+        // Every projectile that hit is still used up.
+        auto hurt_player = [&](int bullet){
+            if (player->state == PLAYER_DYING){
+                return;
+            }
+            player->Hurt();
+            events->Emit(EVENT_PLAYER_HURT);
+            events->Emit(EVENT_INVERSION, bullet);
+        };
+        collisions->Query(LAYER_ENEMY_BULLET, player->d_rect, [&](int b){
+            Projectile &bullet = enemies->bullets.At(b);
+            double time;
+            if (!bullet.Sweep(&player->d_rect, &time) || !player->Touches(bullet.SweptRect())){
+                return;
+            }
+            /*
+                TODO: only use this logic for basic pawn bullets. 
+                differentiate when "projectile" class is created and used
+                instead.
+            */
+            if (!bullet.hit){
+                hurt_player(b);
+            }
+            // a bullet that hit is retired when the enemies are processed.
+            bullet.hit = true;
+        });
+
+        // the projectiles of the emitters are too many for the grid, all of them are tested against the player in
+        // one pass over the field, and the few that come close are swept the same way.
+        ProjectileField &field = enemies->field;
+        field.Query(player->d_rect, [&](int p){
+            SDL_Rect last = field.LastRect(p), now = field.Rect(p);
+            double time;
+            if (!SweepRect(last, now.x - last.x, now.y - last.y, player->d_rect, &time) || !player->Touches(field.SweptRect(p))){
+                return;
+            }
+            if (!field.hit[p]){
+                hurt_player(-1);
+            }
+            field.hit[p] = true;
+        });
     }
 
-    if (shoot_timer >= shot_interval){shoot_timer = 0.0;}
+    enemies->Process(clock, width, height);
+    ApplyCollisionEvents(controllers, jukebox);
 
-    // finally, destroy the enemy ship if it is dead.
-    // for ( auto enemy = enemies.begin(); enemy != enemies.end(); ) {
-    //     if( (*enemy)->dead ) {
-    //         delete * enemy;  
-    //         enemy = enemies.erase(enemy);
-    //     }
-    //     else {
-    //         ++enemy;
-    //     }
-    // }
+    if (shoot_timer >= shot_interval){shoot_timer = 0.0;}
+}
 
+// Every effect is applied once for the tick however many collisions set it off, only the score, the fleet and the
+// flip depend on which and how many there were.
+void LevelScene::ApplyCollisionEvents(ControllerManager * controllers, Jukebox * jukebox){
+    PROFILE_ZONE("ApplyCollisionEvents");
+    if (events->Count(EVENT_ENEMY_HIT)){
+        jukebox->PlaySoundEffect("dying");
+        // every part shot off an enemy is worth a little, destroying the enemy still counts on its own.
+        for (auto &event: events->events){
+            if (event.kind == EVENT_ENEMY_HIT && event.part >= 0){
+                hud->AddScore(50);
+                TRACE_INSTANT("part shot off", enemy_kinds[enemies->kind[enemies->slot[event.subject]]].name);
+            }
+        }
+    }
+    if (events->Count(EVENT_ENEMY_KILLED)){
+        hud->AddScore(events->Count(EVENT_ENEMY_KILLED) * 200);
+        // the fleet loses the enemy and speeds up for the next tick.
+        for (auto &event: events->events){
+            if (event.kind == EVENT_ENEMY_KILLED){
+                fleet->Kill(event.subject);
+                TRACE_INSTANT("enemy death", enemy_kinds[enemies->kind[enemies->slot[event.subject]]].name);
+            }
+        }
+    }
+    if (events->Count(EVENT_PLAYER_HURT)){
+        controllers->SetControllerRumble(0, 0, 60, .3);
+        jukebox->PlaySoundEffect("dying_p");
+    }
+    // two inversions in the same tick turn the screen back.
+    if (events->Count(EVENT_INVERSION) % 2){
+        *flip = (*flip == SDL_FLIP_NONE) ? SDL_FLIP_VERTICAL : SDL_FLIP_NONE;
+    }
+    if (events->Count(EVENT_INVERSION)){
+        jukebox->PlaySoundEffect("inversion");
+    }
+    events->Clear();
 }
 
 void LevelScene::Reset(Jukebox * jukebox){
     *flip = SDL_FLIP_NONE;
 
-    for (auto enemy: enemies){
-        enemy->Reset();        
-    }
+    enemies->Reset();
+    fleet->Reset();
+    // the score only goes up with kills, so it starts over with the enemies.
+    hud->SetScore(0);
 
     player->Reset();
     jukebox->StopMusic();
     jukebox->StopSoundEffects();
-    starting = true;
-    running = false;
-    options = false;
+    scene_state = scene_transitions[scene_state][SCENE_RESET];
     countdown_n = 4;
 }
 
-void LevelScene::RenderScene(){
+// Puts the level back the way it was when it was built, so a level that was played before plays like a new one.
+void LevelScene::Restart(Jukebox * jukebox){
+    Reset(jukebox);
+
+    player->SetPos(player_spawn.x, player_spawn.y);
+    // the rect is where the player is from the first tick on, not where the player was in the last level played.
+    player->d_rect = {player_spawn.x - player_spawn.w / 2, player_spawn.y - player_spawn.h / 2, player_spawn.w, player_spawn.h};
+
+    countdown_sprite->Reset();
+    time_left = 0.0;
+    countdown = 0.0;
+    shoot_timer = 0.0;
+    fleet->phase = PHASE_LEFT;
+    fleet->drop_time = 0.0;
+    enemies_dead = 0;
+    filling_stars = true;
+    paused = false;
+}
+
+void LevelScene::RenderScene(RenderSnapshot * snapshot){
+    PROFILE_ZONE("LevelScene::RenderScene");
+
+    // When paused the positions don't change, so there is nothing to interpolate.
+    if (paused){
+        snapshot->interpolate = false;
+    }
 
     //Rendering
-    framebuffer->SetActiveBuffer("GAME");
-    SDL_SetRenderDrawColor(renderer, 9, 21, 61, 255);
-    SDL_RenderClear(renderer);
+    snapshot->SetTarget("GAME");
+    snapshot->ClearTarget({9, 21, 61, 255});
 
     for (auto star: stars_l1){
-        star->Render();
-    }
-    for (auto enemy: enemies){
-        enemy->Render(); 
+        star->Render(snapshot);
     }
+    enemies->Render(snapshot);
 
-    player->Render();
+    player->Render(snapshot);
 
     for (auto star: stars_l2){
-        star->Render();
+        star->Render(snapshot);
     }
 
-    if (starting){
-        countdown_sprite->Render();
+    if (scene_state == SCENE_STARTING){
+        countdown_sprite->Render(snapshot);
     }
 
-    if (winner){
-        text_renderer->RenderText("YOU WON!", 200, 250, 50, {255, 255, 255, 255}, 2);
+    if (scene_state == SCENE_WON){
+        snapshot->AddText("YOU WON!", 200, 250, 50, {255, 255, 255, 255}, 2);
     }
 
-    if (options){
-        if (*flip == SDL_FLIP_VERTICAL){
-            *flip = SDL_FLIP_NONE;
-        }
-        text_renderer->RenderText("THE ARMADA WON!", 30, 150, 50, {255, 255, 255, 255}, 2);
-        text_renderer->RenderText("Press 'Q' to quit. (X on controller)\n Press 'R' to restart. (A on controller)", 10, 300, 18, {255, 255, 255, 255}, 2);
+    if (scene_state == SCENE_LOST){
+        snapshot->AddText("THE ARMADA WON!", 30, 150, 50, {255, 255, 255, 255}, 2);
+        snapshot->AddText("Press 'Q' to quit. (X on controller)\n Press 'R' to restart. (A on controller)", 10, 300, 18, {255, 255, 255, 255}, 2);
     }
 
-    framebuffer->UnsetBuffers();
+    snapshot->SetTarget(nullptr);
     
-    hud->Render();
+    hud->Render(snapshot);
+}
+
+int LevelScene::GetScore(){
+    return hud->score;
 }
 
-LevelScene::~LevelScene(){
-    for (int i=0; i < stars_l1.size(); i++){
-        delete stars_l1[i];
+bool LevelScene::IsOver(){
+    return scene_state == SCENE_LOST || scene_state == SCENE_WON;
+}
+
+void LevelScene::Seed(unsigned int seed){
+    rng.seed(seed);
+}
+
+// FNV-1a hash over everything that decides how the level plays out, two runs that end with the same hash played the same.
+Uint64 LevelScene::StateHash(){
+    Uint64 hash = 14695981039346656037ull;
+    auto mix = [&hash](const void * data, size_t size){
+        const Uint8 * bytes = static_cast<const Uint8 *>(data);
+        for (size_t i = 0; i < size; i++){
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    int score = GetScore();
+    mix(&score, sizeof(score));
+    mix(&player->lives, sizeof(player->lives));
+    mix(&player->x_pos, sizeof(player->x_pos));
+    mix(&player->y_pos, sizeof(player->y_pos));
+    // the states are hashed by name, so hashes of replays recorded when they were strings still match.
+    mix(player_state_names[player->state], strlen(player_state_names[player->state]));
+    for (auto &bullet: player->bullets){
+        mix(&bullet.x_pos, sizeof(bullet.x_pos));
+        mix(&bullet.y_pos, sizeof(bullet.y_pos));
+    }
+
+    // in the order the enemies were added, wherever they are kept now.
+    for (int k = 0; k < enemies->count; k++){
+        int i = enemies->slot[k];
+        mix(&enemies->x[i], sizeof(enemies->x[i]));
+        mix(&enemies->y[i], sizeof(enemies->y[i]));
+        mix(enemy_state_names[enemies->state[i]], strlen(enemy_state_names[enemies->state[i]]));
+        // only enemies made of parts have any, so the hashes of levels without them don't change.
+        if (enemies->Compound(i)){
+            mix(&enemies->parts[i], sizeof(enemies->parts[i]));
+        }
     }
-    for (int i=0; i < stars_l2.size(); i++){
-        delete stars_l2[i];
+    for (auto &bullet: enemies->bullets){
+        mix(&bullet.x_pos, sizeof(bullet.x_pos));
+        mix(&bullet.y_pos, sizeof(bullet.y_pos));
     }
-    for (int i=0; i < enemies.size(); i++){
-        delete enemies[i];
+    for (int p = 0; p < enemies->field.count; p++){
+        mix(&enemies->field.x[p], sizeof(enemies->field.x[p]));
+        mix(&enemies->field.y[p], sizeof(enemies->field.y[p]));
     }
-    delete countdown_sprite;
-	delete hud;
+    return hash;
+}
+
+ArenaStats LevelScene::ArenaUsage(){
+    return arena.Stats();
 }
 
+// the stars, enemies, hud and countdown are all released along with the arena.
+LevelScene::~LevelScene(){}
+
 
-MenuScene::MenuScene(SpriteCache * cache, Framebuffer * framebuffer, TextCache * text, SDL_RendererFlip * flip, Player * player){
-    this->framebuffer = framebuffer;
+MenuScene::MenuScene(SpriteCache * cache, SDL_RendererFlip * flip, Player * player){
     this->cache = cache;
     for (int i=0; i < 40; i++){
             int random_x = rand() %  (1280 - 5)+ 10;
             int random_y = rand() % (720 - 5) + 10;
-            stars.push_back(new Bullet(cache->renderer, random_x, random_y, 5, 5, {255, 255, 255, 255}));
+            stars.push_back(new Bullet(random_x, random_y, 5, 5, {255, 255, 255, 255}));
         }
     starting = true;
     running = false;
     finished = false;
-    renderer = cache->renderer;
-    text_cache = text;
     this->flip = flip;
     this->player = player;
 
     title = new AnimatedSprite(cache, {0, 0, 64, 64}, {640, 270, 700, 380}, "resources/title.bmp", 64, 7, .16);
-    buttons["start"] = new SpriteButton(cache, "resources/start_button.bmp", 640, 540, 150, 100, {0, 0, 64, 64}, 7, 64, .06);
-
-    level_options["level1"] = new SpriteButton(cache, "resources/level1.bmp", 470, 660, 150, 100, {0, 0, 64, 64}, 2, -64, .03);
-    level_options["level2"] = new SpriteButton(cache, "resources/level2.bmp", 640, 660, 150, 100, {0, 0, 64, 64}, 2, -64, .03);
-    level_options["level3"] = new SpriteButton(cache, "resources/level3.bmp", 810, 660, 150, 100, {0, 0, 64, 64}, 2, -64, .03);
+    start_button = new SpriteButton(cache, "resources/start_button.bmp", 640, 540, 150, 100, {0, 0, 64, 64}, 7, 64, .06);
+
+    level_options.push_back(new SpriteButton(cache, "resources/level1.bmp", 470, 660, 150, 100, {0, 0, 64, 64}, 2, -64, .03));
+    level_paths.push_back("resources/levels/level.mx");
+    level_options.push_back(new SpriteButton(cache, "resources/level2.bmp", 640, 660, 150, 100, {0, 0, 64, 64}, 2, -64, .03));
+    level_paths.push_back("resources/levels/level2.mx");
+    level_options.push_back(new SpriteButton(cache, "resources/level3.bmp", 810, 660, 150, 100, {0, 0, 64, 64}, 2, -64, .03));
+    level_paths.push_back("resources/levels/level3.mx");
     song_ending_time = 82.9;
     animate_interval = 1.2;
 }
@@ -445,19 +595,15 @@ MenuScene::~MenuScene(){
         delete stars[i];
     }
 
-    for (auto const &button : buttons){
-            delete button.second;
-    }
-    buttons.clear();
-
-    for (auto const &options: level_options){
-        delete options.second;
+    delete start_button;
+    for (auto option: level_options){
+        delete option;
     }
     level_options.clear();
     delete title;
 }
 
-bool MenuScene::Process(Clock * clock, MouseManager * mouse, Jukebox * jukebox, string * state, string * path){
+bool MenuScene::Process(Clock * clock, MouseManager * mouse, Jukebox * jukebox, GameState * state, string * path){
     if (starting){
         jukebox->PlayMusic("title");
         running = true;
@@ -466,37 +612,21 @@ bool MenuScene::Process(Clock * clock, MouseManager * mouse, Jukebox * jukebox,
     if (running){
         seconds_passed += clock->delta_time_s;
 
-        if (buttons["start"]->MouseClicking(mouse) && !select_options){
+        if (start_button->MouseClicking(mouse) && !select_options){
             select_options = true;
         }
 
         if (select_options){
-            if (level_options["level1"]->MouseClicking(mouse)){
-                *state = "GAME";
-                *path = "resources/levels/level.mx";
-                jukebox->StopMusic();
-                title->Reset();
-                select_options = false;
-                seconds_passed = 0;
-                return 1;
-            }
-            if (level_options["level2"]->MouseClicking(mouse)){
-                *state = "GAME";
-                *path = "resources/levels/level2.mx";
-                jukebox->StopMusic();
-                title->Reset();
-                select_options = false;
-                seconds_passed = 0;
-                return 1;
-            }
-            if (level_options["level3"]->MouseClicking(mouse)){
-                *state = "GAME";
-                *path = "resources/levels/level3.mx";
-                jukebox->StopMusic();
-                title->Reset();
-                select_options = false;
-                seconds_passed = 0;
-                return 1;
+            for (size_t i = 0; i < level_options.size(); i++){
+                if (level_options[i]->MouseClicking(mouse)){
+                    *state = game_transitions[*state][GAME_LEVEL_CHOSEN];
+                    *path = level_paths[i];
+                    jukebox->StopMusic();
+                    title->Reset();
+                    select_options = false;
+                    seconds_passed = 0;
+                    return 1;
+                }
             }
         }
 
@@ -505,50 +635,56 @@ bool MenuScene::Process(Clock * clock, MouseManager * mouse, Jukebox * jukebox,
             title->Animate(clock);
         }
         
-        for (auto const &button : buttons){
-            button.second->Process(clock);
-        }
+        start_button->Process(clock);
 
         if (select_options){
-            for (auto const &option: level_options){
-                option.second->Process(clock);
+            for (auto option: level_options){
+                option->Process(clock);
             }
         }
 
         // Move the stars.
         for (auto star: stars){
+            star->last_y = star->y_pos;
             star->y_pos += (3 * 100) * clock->delta_time_s;
             if (star->y_pos >= 720){
                 star->y_pos = star->y_pos - 720;
+                star->last_y = star->last_y - 720;
             }
         }
     }
     return 0;
 }
 
-void MenuScene::RenderScene(){
+bool MenuScene::ShowingLevels(){
+    return select_options;
+}
+
+const vector<string> & MenuScene::LevelPaths(){
+    return level_paths;
+}
+
+void MenuScene::RenderScene(RenderSnapshot * snapshot){
+    PROFILE_ZONE("MenuScene::RenderScene");
     //Rendering
-    framebuffer->SetActiveBuffer("MENU");
-    SDL_SetRenderDrawColor(renderer, 9, 21, 61, 255);
-    SDL_RenderClear(renderer);
+    snapshot->SetTarget("MENU");
+    snapshot->ClearTarget({9, 21, 61, 255});
 
     for (auto star: stars){
-        star->Render();
+        star->Render(snapshot);
     }
     
-    for (auto const &button : buttons){
-            button.second->Render();
-    }
+    start_button->Render(snapshot);
 
-    title->Render();
+    title->Render(snapshot);
 
     if (select_options){
-        for (auto const &option : level_options){
-            option.second->Render();
+        for (auto option : level_options){
+            option->Render(snapshot);
         }
     }
 
-    framebuffer->UnsetBuffers();
+    snapshot->SetTarget(nullptr);
 }
 
 
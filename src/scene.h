@@ -3,52 +3,70 @@
 #include "jukebox.h"
 #include "enemy.h"
 #include "player.h"
-#include "text.h"
-#include "framebuffer.h"
+#include "snapshot.h"
 #include "controller.h"
 #include "hud.h"
 #include "bullets.h"
 #include "buttons.h"
+#include "input.h"
+#include "arena.h"
+#include "collision.h"
+#include "fleet.h"
 
+/*
+    Everything a level owns is made in its arena, and goes with it when the level is deleted.
+*/
 class LevelScene {
 private:
-    vector<Bullet *> stars_l1;
-    vector<Bullet *> stars_l2;
-    vector<Enemy * > enemies = {};
-    vector<int> erased_enemy_i = {};
+    Arena arena;
+    ArenaVector<Bullet *> stars_l1;
+    ArenaVector<Bullet *> stars_l2;
+    EnemyStore * enemies;
+    // the formation the enemies march in.
+    Fleet * fleet;
+    // the broadphase of the collisions between the player, its bullets, the enemies and their bullets.
+    CollisionGrid * collisions;
+    // the player bullets that went through an enemy this tick, in the order of the enemies, and the earliest time
+    // every bullet hit something.
+    ArenaVector<CollisionHit> bullet_hits;
+    ArenaVector<double> first_impact;
+    // what the collisions of this tick set off.
+    CollisionEvents * events;
     Player * player = nullptr;
+    // where the level puts the player and how big, the player is shared by all levels.
+    SDL_Rect player_spawn = {};
     double time_left = 0.0;
     double countdown = 0.0;
     int countdown_n = 4;
     double shoot_timer = 0.0;
     double shot_interval = 0.0;
-    string direction = "left";
-    string enemy_state = "PHASE_LEFT";
-    string last_state;
     int enemies_dead = 0;
     AnimatedSprite * countdown_sprite;
-    SDL_Renderer * renderer;
-    Framebuffer * framebuffer;
-    TextCache * text_renderer;
     Hud * hud;
     SDL_RendererFlip * flip;
     bool filling_stars = true;
-    bool options = false;
-    bool winner = false;
+    SceneState scene_state = SCENE_STARTING;
+    // every level has its own random generator, so levels running side by side don't affect each other.
+    mt19937 rng;
 public:
-    bool starting;
-    bool running;
-    bool finished;
-    bool paused;
-    LevelScene(SDL_Renderer * renderer, Framebuffer * Framebuffer, SpriteCache * , TextCache *,SDL_RendererFlip * flip);
+    // pausing stops the simulation in any state the level is played in, so it is kept apart from the state.
+    bool paused = false;
+    LevelScene(SpriteCache *, SDL_RendererFlip * flip);
     
-    void AddEnemy(Enemy * enemy);
-    void AddPlayer(Player * player);
+    void AddEnemy(EnemyKind kind, int x, int y, int w, int h);
+    void AddPlayer(Player * player, int x, int y, int w, int h);
     void CreateHUD(Player * player);
     void Reset(Jukebox * jukebox);
-    void Process(Clock * clock, KeyboardManager * keyboard, MouseManager * mouse, ControllerManager * controllers, Jukebox * jukebox, string *state, int width, int height);
+    void Restart(Jukebox * jukebox);
+    void Process(Clock * clock, PlayerInput * input, ControllerManager * controllers, Jukebox * jukebox, GameState * state, int width, int height);
     void ManageEnemies(Clock * clock, ControllerManager * controllers, Jukebox * jukebox, int width, int height);
-    void RenderScene();
+    void ApplyCollisionEvents(ControllerManager * controllers, Jukebox * jukebox);
+    void RenderScene(RenderSnapshot * snapshot);
+    int GetScore();
+    bool IsOver();
+    void Seed(unsigned int seed);
+    Uint64 StateHash();
+    ArenaStats ArenaUsage();
 
     ~LevelScene();
 };
@@ -58,13 +76,12 @@ class MenuScene {
         Player * player;
         SDL_RendererFlip * flip;
         SpriteCache * cache;
-        Framebuffer * framebuffer;
         AnimatedSprite * title;
-        map<string, Button *> buttons;
-        map<string, Button *> level_options;
+        Button * start_button;
+        // the level buttons, in the order they are drawn, with the level each of them starts.
+        vector<Button *> level_options;
+        vector<string> level_paths;
         vector<Bullet *> stars;
-        SDL_Renderer * renderer;
-        TextCache * text_cache;
         double seconds_passed = 0.0;
         double animate_interval = 0.0;
         double song_ending_time = 0.0;
@@ -74,8 +91,10 @@ class MenuScene {
         bool starting;
         bool running;
         bool finished;
-        MenuScene(SpriteCache *, Framebuffer * framebuffer, TextCache *, SDL_RendererFlip *, Player *);
+        MenuScene(SpriteCache *, SDL_RendererFlip *, Player *);
         ~MenuScene();
-        bool Process(Clock * clock, MouseManager * mouse, Jukebox * jukebox, string * state, string * scene_path);
-        void RenderScene();
+        bool Process(Clock * clock, MouseManager * mouse, Jukebox * jukebox, GameState * state, string * scene_path);
+        bool ShowingLevels();
+        const vector<string> & LevelPaths();
+        void RenderScene(RenderSnapshot * snapshot);
 };
\ No newline at end of file
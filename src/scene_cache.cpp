@@ -0,0 +1,101 @@
+#include "scene_cache.h"
+#include "functions.h"
+#include "trace.h"
+
+// what a scene costs: its arena and the scene itself.
+static size_t SceneMemory(LevelScene * scene){
+    return scene->ArenaUsage().capacity + sizeof(LevelScene);
+}
+
+SceneCache::SceneCache(SpriteCache * cache, Player * player, SDL_RendererFlip * flip, size_t memory_cap){
+    this->cache = cache;
+    this->player = player;
+    this->flip = flip;
+    this->memory_cap = memory_cap;
+}
+
+SceneCache::Entry * SceneCache::Find(string path){
+    for (auto &entry: entries){
+        if (entry.path == path){
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool SceneCache::Prebuild(const vector<string> &paths){
+    if (MemoryUsed() >= memory_cap){
+        return false;
+    }
+
+    for (auto &path: paths){
+        if (!Find(path) && find(failed.begin(), failed.end(), path) == failed.end()){
+            LevelScene * scene = CreateScene(cache, player, path, flip);
+            if (scene){
+                entries.push_back({path, scene, 0});
+            }
+            else {
+                failed.push_back(path);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+LevelScene * SceneCache::Get(string path, Jukebox * jukebox){
+    TRACE_INSTANT("scene", path.c_str());
+    Entry * entry = Find(path);
+    if (!entry){
+        LevelScene * scene = CreateScene(cache, player, path, flip);
+        if (!scene){
+            if (find(failed.begin(), failed.end(), path) == failed.end()){
+                failed.push_back(path);
+            }
+            return nullptr;
+        }
+        entries.push_back({path, scene, 0});
+        entry = &entries.back();
+    }
+    entry->last_used = ++uses;
+
+    LevelScene * scene = entry->scene;
+    scene->Restart(jukebox);
+    Trim(scene);
+    return scene;
+}
+
+void SceneCache::Trim(LevelScene * keep){
+    while (MemoryUsed() > memory_cap){
+        // the scene played longest ago goes first, and a scene that was only prebuilt before any that was played.
+        int oldest = -1;
+        for (int i = 0; i < int(entries.size()); i++){
+            if (entries[i].scene != keep && (oldest == -1 || entries[i].last_used < entries[oldest].last_used)){
+                oldest = i;
+            }
+        }
+        if (oldest == -1){
+            return;
+        }
+        delete entries[oldest].scene;
+        entries.erase(entries.begin() + oldest);
+    }
+}
+
+size_t SceneCache::MemoryUsed(){
+    size_t used = 0;
+    for (auto &entry: entries){
+        used += SceneMemory(entry.scene);
+    }
+    return used;
+}
+
+int SceneCache::Size(){
+    return entries.size();
+}
+
+SceneCache::~SceneCache(){
+    for (auto &entry: entries){
+        delete entry.scene;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "headers.h"
+#include "scene.h"
+
+/*
+    Levels that were built once are kept here, ready to be played again, so entering a level doesn't read the
+    level file or build anything. While the menu shows the level buttons the levels are built ahead of time,
+    one a tick so no tick takes long, and a level that is played again is put back to the start with Restart.
+    Everything runs on the simulation thread, the scenes use the sprite cache just like when they are played.
+
+    Together the scenes may use up to memory_cap bytes. Prebuilding stops at the cap, and when a level is
+    entered the scenes played least recently are deleted until the cache fits under it again.
+*/
+class SceneCache {
+    private:
+        struct Entry {
+            string path;
+            LevelScene * scene;
+            // when the level was entered last, levels that were only prebuilt are 0.
+            Uint64 last_used;
+        };
+
+        SpriteCache * cache;
+        Player * player;
+        SDL_RendererFlip * flip;
+        vector<Entry> entries;
+        // levels that couldn't be loaded are never cached, and not built ahead of time again.
+        vector<string> failed;
+        Uint64 uses = 0;
+
+        Entry * Find(string path);
+        void Trim(LevelScene * keep);
+
+    public:
+        size_t memory_cap;
+
+        SceneCache(SpriteCache * cache, Player * player, SDL_RendererFlip * flip, size_t memory_cap = 4 * 1024 * 1024);
+        ~SceneCache();
+
+        // builds the first of the levels that isn't built yet, returns false when there was nothing to build.
+        bool Prebuild(const vector<string> &paths);
+        // the level at the start, ready to be played. it is built now if it wasn't built before, and is nullptr if the
+        // level couldn't be loaded.
+        LevelScene * Get(string path, Jukebox * jukebox);
+        size_t MemoryUsed();
+        int Size();
+};
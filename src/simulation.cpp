@@ -0,0 +1,64 @@
+#include "simulation.h"
+#include "functions.h"
+
+Simulation::Simulation(string level_path, double tick_rate, unsigned int seed){
+    clock.SetDelta(1.0 / tick_rate);
+
+    // none of these have a device behind them, they only exist so the level can be built the same way it is in game.
+    cache = new SpriteCache(nullptr);
+    jukebox = new Jukebox(false);
+    controllers = new ControllerManager(false);
+    player = new Player(cache, 640, 600, 50, 50, "resources/player.bmp");
+
+    scene = CreateScene(cache, player, level_path, &flip);
+    if (!scene){
+        return;
+    }
+    scene->Restart(jukebox);
+    scene->Seed(seed);
+}
+
+bool Simulation::Loaded(){
+    return scene != nullptr;
+}
+
+void Simulation::Tick(PlayerInput * input){
+    if (!Finished()){
+        scene->Process(&clock, input, controllers, jukebox, &state, width, height);
+    }
+    ticks++;
+}
+
+void Simulation::Render(RenderSnapshot * snapshot){
+    snapshot->Clear();
+    snapshot->state = state;
+    snapshot->flip = flip;
+    if (!Finished()){
+        scene->RenderScene(snapshot);
+    }
+}
+
+int Simulation::Score(){
+    return scene->GetScore();
+}
+
+int Simulation::Lives(){
+    return player->lives;
+}
+
+bool Simulation::Finished(){
+    // the level sends the game back to the menu once it was won or quit.
+    return !scene || state != GAME_LEVEL;
+}
+
+Uint64 Simulation::StateHash(){
+    return scene->StateHash();
+}
+
+Simulation::~Simulation(){
+    delete scene;
+    delete player;
+    delete controllers;
+    delete jukebox;
+    delete cache;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include "headers.h"
+#include "scene.h"
+#include "input.h"
+
+/*
+    A simulation runs a single level without a window, renderer or audio device. It owns everything the
+    level needs, so the level can be stepped tick by tick with whatever input is given to it. This is used
+    by the headless mode to run gameplay tests on machines without a GPU, and by the replay farm.
+
+    Nothing here is shared with other simulations, so any number of them can run on different threads.
+*/
+class Simulation {
+    private:
+        SpriteCache * cache;
+        Jukebox * jukebox;
+        ControllerManager * controllers;
+        Player * player;
+        LevelScene * scene;
+        Clock clock;
+        SDL_RendererFlip flip = SDL_FLIP_NONE;
+        GameState state = GAME_LEVEL;
+
+    public:
+        int width = 800, height = 600;
+        long ticks = 0;
+
+        Simulation(string level_path, double tick_rate = 120.0, unsigned int seed = 0);
+        ~Simulation();
+
+        // false when the level file couldn't be loaded, such a simulation is finished from the start and has no score.
+        bool Loaded();
+
+        void Tick(PlayerInput * input);
+        // records the level into a snapshot the way the game does after its ticks, nothing is drawn.
+        void Render(RenderSnapshot * snapshot);
+        int Score();
+        int Lives();
+        bool Finished();
+        Uint64 StateHash();
+};
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "snapshot.h"
+#include "profiler.h"
+
+RenderSnapshot::RenderSnapshot(){
+    // enough for all the text of a level, so the first long message doesn't make it grow in the middle of play.
+    text.reserve(256);
+}
+
+void RenderSnapshot::Clear(){
+    // clearing keeps the memory of the vectors, so recording a snapshot doesn't allocate once it has grown.
+    commands.clear();
+    text.clear();
+    interpolate = true;
+}
+
+void RenderSnapshot::SetTarget(const char * buffer){
+    DrawCommand command;
+    command.type = DRAW_TARGET;
+    command.target = buffer;
+    commands.push_back(command);
+}
+
+void RenderSnapshot::ClearTarget(SDL_Color color){
+    DrawCommand command;
+    command.type = DRAW_CLEAR;
+    command.color = color;
+    commands.push_back(command);
+}
+
+void RenderSnapshot::AddSprite(SDL_Texture * texture, SDL_Rect * s_rect, int w, int h, double x, double y, double last_x, double last_y, double angle, SDL_RendererFlip flip){
+    DrawCommand command;
+    command.type = DRAW_SPRITE;
+    command.texture = texture;
+    if (s_rect){
+        command.s_rect = *s_rect;
+        command.source_rect = true;
+    }
+    command.w = w;
+    command.h = h;
+    command.x = x;
+    command.y = y;
+    command.last_x = last_x;
+    command.last_y = last_y;
+    command.angle = angle;
+    command.flip = flip;
+    commands.push_back(command);
+}
+
+void RenderSnapshot::AddRect(SDL_Color color, int w, int h, double x, double y, double last_x, double last_y){
+    DrawCommand command;
+    command.type = DRAW_RECT;
+    command.color = color;
+    command.w = w;
+    command.h = h;
+    command.x = x;
+    command.y = y;
+    command.last_x = last_x;
+    command.last_y = last_y;
+    commands.push_back(command);
+}
+
+void RenderSnapshot::AddText(const char * text, int x, int y, int size, SDL_Color color, int offset){
+    DrawCommand command;
+    command.type = DRAW_TEXT;
+    command.text_start = this->text.size();
+    command.text_length = strlen(text);
+    command.x = x;
+    command.y = y;
+    command.size = size;
+    command.color = color;
+    command.offset = offset;
+    this->text += text;
+    commands.push_back(command);
+}
+
+void RenderSnapshot::Draw(Framebuffer * framebuffer, TextCache * text_cache, double alpha){
+    PROFILE_ZONE("RenderSnapshot::Draw");
+    SDL_Renderer * renderer = framebuffer->renderer;
+    if (!interpolate){
+        alpha = 1.0;
+    }
+
+    for (auto &command: commands){
+        // the rect is drawn in between the previous and the current tick.
+        SDL_Rect d_rect = {
+            int(command.last_x + (command.x - command.last_x) * alpha) - (command.w / 2),
+            int(command.last_y + (command.y - command.last_y) * alpha) - (command.h / 2),
+            command.w, command.h
+        };
+
+        switch (command.type){
+            case DRAW_TARGET:
+                if (command.target){
+                    framebuffer->SetActiveBuffer(command.target);
+                }
+                else {
+                    framebuffer->UnsetBuffers();
+                }
+                break;
+
+            case DRAW_CLEAR:
+                SDL_SetRenderDrawColor(renderer, command.color.r, command.color.g, command.color.b, command.color.a);
+                SDL_RenderClear(renderer);
+                break;
+
+            case DRAW_SPRITE:
+                SDL_RenderCopyEx(renderer, command.texture, command.source_rect ? &command.s_rect : NULL, &d_rect, command.angle, nullptr, command.flip);
+                break;
+
+            case DRAW_RECT:
+                SDL_SetRenderDrawColor(renderer, command.color.r, command.color.g, command.color.b, command.color.a);
+                SDL_RenderFillRect(renderer, &d_rect);
+                break;
+
+            case DRAW_TEXT:
+                text_cache->RenderText(text.c_str() + command.text_start, command.text_length, command.x, command.y, command.size, command.color, command.offset);
+                break;
+        }
+    }
+    framebuffer->UnsetBuffers();
+}
\ No newline at end of file
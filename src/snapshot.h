@@ -0,0 +1,57 @@
+#pragma once
+#include "headers.h"
+#include "framebuffer.h"
+#include "text.h"
+
+enum DrawCommandType {
+    DRAW_TARGET,
+    DRAW_CLEAR,
+    DRAW_SPRITE,
+    DRAW_RECT,
+    DRAW_TEXT
+};
+
+// One thing to draw. Positions are the centre of the drawn rect, for the current and the previous tick.
+struct DrawCommand {
+    DrawCommandType type;
+    const char * target = nullptr;
+    SDL_Texture * texture = nullptr;
+    SDL_Rect s_rect = {};
+    bool source_rect = false;
+    int w = 0, h = 0;
+    double x = 0, y = 0;
+    double last_x = 0, last_y = 0;
+    double angle = 0;
+    SDL_RendererFlip flip = SDL_FLIP_NONE;
+    SDL_Color color = {0, 0, 0, 255};
+    int text_start = 0, text_length = 0;
+    int size = 0, offset = 0;
+};
+
+/*
+    Everything needed to draw one tick of the game. The scenes record into a snapshot at the end of
+    a tick instead of drawing directly, so that the simulation never has to wait on the renderer.
+    Only Draw uses the renderer, and it is called on the render thread.
+*/
+class RenderSnapshot {
+    public:
+        vector<DrawCommand> commands;
+        string text;
+        GameState state = GAME_MENU;
+        SDL_RendererFlip flip = SDL_FLIP_NONE;
+        bool interpolate = true;
+        // performance counter value of when the snapshot was published.
+        Uint64 time = 0;
+
+        RenderSnapshot();
+
+        void Clear();
+        void SetTarget(const char * buffer);
+        void ClearTarget(SDL_Color color);
+        void AddSprite(SDL_Texture * texture, SDL_Rect * s_rect, int w, int h, double x, double y, double last_x, double last_y,
+                        double angle = 0, SDL_RendererFlip flip = SDL_FLIP_NONE);
+        void AddRect(SDL_Color color, int w, int h, double x, double y, double last_x, double last_y);
+        void AddText(const char * text, int x, int y, int size, SDL_Color color = {0, 0, 0, 255}, int offset = 5);
+
+        void Draw(Framebuffer * framebuffer, TextCache * text_cache, double alpha);
+};
\ No newline at end of file
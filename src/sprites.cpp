@@ -6,17 +6,176 @@ SpriteCache::SpriteCache(SDL_Renderer * r){
 }
 
 SDL_Texture * SpriteCache::LoadTexture(string filepath){
-    if (textures.find(filepath) == textures.end()) {
-        SDL_Surface * surface = SDL_LoadBMP(filepath.c_str());
-        if (!surface){
-            ShowError("Space Inversion Error!", (filepath + " not found!, can't load!"), "file not loaded", false);
-        }
-        textures[filepath] = SDL_CreateTextureFromSurface(renderer, surface);
-        SDL_FreeSurface(surface);
+    // without a renderer (headless mode) there is nothing to draw with, so no textures are loaded.
+    if (!renderer){
+        return nullptr;
+    }
+
+    auto texture = textures.find(filepath);
+    if (texture != textures.end()){
+        return texture->second;
+    }
+
+    // Textures can only be created on the render thread. Once everything is preloaded the cache is only read,
+    // which is safe from the simulation thread, so anything that wasn't preloaded is an error.
+    if (preloaded){
+        ShowError("Space Inversion Error!", (filepath + " wasn't preloaded, can't load!"), "file not loaded", false);
+        return nullptr;
+    }
+
+    SDL_Surface * surface = SDL_LoadBMP(filepath.c_str());
+    if (!surface){
+        ShowError("Space Inversion Error!", (filepath + " not found!, can't load!"), "file not loaded", false);
     }
+    textures[filepath] = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
     return textures[filepath];
 }
 
+void SpriteCache::Preload(string directory){
+    if (renderer){
+        for (auto const &entry : filesystem::recursive_directory_iterator(directory)){
+            if (entry.path().extension() == ".bmp"){
+                LoadTexture(entry.path().generic_string());
+            }
+        }
+    }
+    preloaded = true;
+}
+
+int SpriteCache::AddClip(string path, SDL_Rect s_rect, int frame_offset, int frame_count, double frame_time, int grow, SDL_RendererFlip flip){
+    for (size_t i = 0; i < clips.size(); i++){
+        AnimationClip &clip = clips[i];
+        if (clip.path == path && clip.s_rect.x == s_rect.x && clip.s_rect.y == s_rect.y && clip.s_rect.w == s_rect.w &&
+            clip.s_rect.h == s_rect.h && clip.frame_offset == frame_offset && clip.frame_count == frame_count &&
+            clip.frame_time == frame_time && clip.grow == grow && clip.flip == flip){
+            return i;
+        }
+    }
+
+    AnimationClip clip;
+    clip.path = path;
+    clip.texture = LoadTexture(path);
+    clip.s_rect = s_rect;
+    clip.source_rect = s_rect.x || s_rect.y || s_rect.w || s_rect.h;
+    clip.frame_offset = frame_offset;
+    clip.frame_count = frame_count;
+    clip.frame_time = frame_time;
+    clip.grow = grow;
+    clip.flip = flip;
+    clips.push_back(clip);
+    return clips.size() - 1;
+}
+
+const AnimationClip & SpriteCache::GetClip(int clip){
+    return clips[clip];
+}
+
+int SpriteCache::AddMask(int clip, int w, int h){
+    for (auto &set: mask_sets){
+        if (set.clip == clip && set.w == w && set.h == h){
+            return set.first;
+        }
+    }
+
+    const AnimationClip &drawn = clips[clip];
+    int first = masks.size();
+    mask_sets.push_back({clip, w, h, first});
+
+    // read as 32 bit ARGB whatever the file has, an image without alpha comes out opaque.
+    SDL_Surface * surface = nullptr;
+    SDL_Surface * loaded = SDL_LoadBMP(drawn.path.c_str());
+    if (loaded){
+        surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(loaded);
+    }
+    if (!surface || w <= 0 || h <= 0){
+        // without the pixels every frame is solid, and hits are tested by rect.
+        masks.resize(first + drawn.frame_count);
+        if (surface){
+            SDL_FreeSurface(surface);
+        }
+        return first;
+    }
+
+    SDL_LockSurface(surface);
+    for (int frame = 0; frame < drawn.frame_count; frame++){
+        SDL_Rect s_rect = drawn.source_rect ? drawn.s_rect : SDL_Rect{0, 0, surface->w, surface->h};
+        s_rect.x += frame * drawn.frame_offset;
+        CollisionMask mask(w, h);
+        // every pixel it is drawn to takes the nearest pixel of the source rect, flipped the way the clip is.
+        for (int y = 0; y < h; y++){
+            int v = (drawn.flip & SDL_FLIP_VERTICAL) ? h - 1 - y : y;
+            int source_y = s_rect.y + v * s_rect.h / h;
+            if (source_y < 0 || source_y >= surface->h){
+                continue;
+            }
+            const Uint32 * row = reinterpret_cast<const Uint32 *>(static_cast<const Uint8 *>(surface->pixels) + source_y * surface->pitch);
+            for (int x = 0; x < w; x++){
+                int u = (drawn.flip & SDL_FLIP_HORIZONTAL) ? w - 1 - x : x;
+                int source_x = s_rect.x + u * s_rect.w / w;
+                if (source_x >= 0 && source_x < surface->w && (row[source_x] >> 24)){
+                    mask.Set(x, y);
+                }
+            }
+        }
+        masks.push_back(mask);
+    }
+    SDL_UnlockSurface(surface);
+    SDL_FreeSurface(surface);
+    return first;
+}
+
+const CollisionMask & SpriteCache::GetMask(int mask){
+    return masks[mask];
+}
+
+void SpriteCache::Play(Playhead * playhead, int clip){
+    // switching to another clip starts it from the first frame, playing the same clip again keeps going.
+    if (playhead->clip != clip){
+        playhead->clip = clip;
+        Rewind(playhead);
+    }
+}
+
+void SpriteCache::Rewind(Playhead * playhead){
+    playhead->frame = 0;
+    playhead->elapsed = 0.0;
+    playhead->finished = false;
+}
+
+void SpriteCache::Advance(Playhead * playheads, int count, double seconds){
+    for (int i = 0; i < count; i++){
+        Playhead &playhead = playheads[i];
+        const AnimationClip &clip = clips[playhead.clip];
+        if (clip.frame_time <= 0.0){
+            playhead.finished = true;
+            continue;
+        }
+
+        playhead.elapsed += seconds;
+        if (playhead.elapsed >= clip.frame_time){
+            playhead.frame++;
+            if (playhead.frame >= clip.frame_count){
+                playhead.frame = 0;
+                playhead.finished = true;
+            }
+            playhead.elapsed = 0.0;
+        }
+    }
+}
+
+void SpriteCache::RenderClip(RenderSnapshot * snapshot, int clip, Playhead * playhead, int w, int h, double x, double y,
+                            double last_x, double last_y, double angle){
+    const AnimationClip &drawn = clips[clip];
+    // a clip that was only just switched to isn't playing yet, so it shows its first frame.
+    int frame = playhead->clip == clip ? playhead->frame : 0;
+    SDL_Rect s_rect = drawn.s_rect;
+    s_rect.x += frame * drawn.frame_offset;
+    snapshot->AddSprite(drawn.texture, drawn.source_rect ? &s_rect : nullptr, w + drawn.grow, h + drawn.grow, x, y, last_x, last_y,
+                        angle, drawn.flip);
+}
+
 SpriteCache::~SpriteCache(){
     for (auto const &instance : textures){
         SDL_DestroyTexture(instance.second);
@@ -34,7 +193,6 @@ Sprite::Sprite(SpriteCache * cache, SDL_Rect s, SDL_Rect d, string filepath, dou
     } 
     starting_s_x = s_rect.x;
     starting_s_y = s_rect.y;
-    renderer = cache->renderer;
     angle = a;
     flip = f;
     x = d_rect.x;
@@ -46,6 +204,8 @@ void Sprite::Animate(Clock * clock){finished = true;}
 void Sprite::SetPos(int xpos, int ypos){
     x = xpos;
     y = ypos;
+    d_rect.x = (x - (d_rect.w / 2));
+    d_rect.y = (y - (d_rect.h / 2));
 }
 
 void Sprite::SetDestinationR(SDL_Rect * r){
@@ -55,16 +215,12 @@ void Sprite::SetDestinationR(SDL_Rect * r){
     d_rect.h = r->h;
 }
 
-void Sprite::Render(){
-    d_rect.x = (x - (d_rect.w / 2));
-    d_rect.y = (y - (d_rect.h / 2));
+void Sprite::Render(RenderSnapshot * snapshot){
+    Render(snapshot, x, y);
+}
 
-    if (source_rectange){
-        SDL_RenderCopyEx(renderer, texture, &s_rect, &d_rect, angle, nullptr, flip);
-    }else{
-        SDL_RenderCopyEx(renderer, texture, NULL, &d_rect, angle, nullptr, flip);
-    }
-    
+void Sprite::Render(RenderSnapshot * snapshot, double last_x, double last_y){
+    snapshot->AddSprite(texture, source_rectange ? &s_rect : nullptr, d_rect.w, d_rect.h, x, y, last_x, last_y, angle, flip);
 }
 
 void Sprite::Reset(){}
@@ -1,15 +1,68 @@
 #pragma once
 #include "headers.h"
+#include "snapshot.h"
+#include "mask.h"
+
+/*
+    An animation, stored once in the SpriteCache and shared by everything that plays it. The frames are laid
+    out next to each other in the texture, frame_offset pixels apart. A clip without a frame time is a still image.
+*/
+struct AnimationClip {
+    string path;
+    SDL_Texture * texture = nullptr;
+    SDL_Rect s_rect = {};
+    bool source_rect = true;
+    int frame_offset = 0;
+    int frame_count = 1;
+    double frame_time = 0.0;
+    // the clip is drawn this many pixels wider and taller than the thing playing it, like an explosion.
+    int grow = 0;
+    SDL_RendererFlip flip = SDL_FLIP_NONE;
+};
+
+// Where something is in the clip it plays, this is all the animation state an entity keeps.
+struct Playhead {
+    int clip = -1;
+    int frame = 0;
+    double elapsed = 0.0;
+    // set once the last frame was shown, it stays set while the clip loops.
+    bool finished = false;
+};
 
 class SpriteCache{
 private:
     map<string, SDL_Texture *> textures = {}; 
+    vector<AnimationClip> clips;
+    bool preloaded = false;
+    // the masks of every frame of a clip drawn at a size are next to each other, starting at first.
+    struct MaskSet {
+        int clip, w, h;
+        int first;
+    };
+    vector<MaskSet> mask_sets;
+    vector<CollisionMask> masks;
 
 public:
     SDL_Renderer * renderer;
 
     SpriteCache(SDL_Renderer *);
     SDL_Texture * LoadTexture(string);
+    void Preload(string directory = "resources/");
+
+    // Clips are added when the things playing them are built, adding the same clip twice gives back the same id.
+    int AddClip(string path, SDL_Rect s_rect, int frame_offset = 0, int frame_count = 1, double frame_time = 0.0, int grow = 0,
+                SDL_RendererFlip flip = SDL_FLIP_NONE);
+    const AnimationClip & GetClip(int clip);
+    // Collision masks of every frame of a clip drawn w by h, read from the same pixels the clip draws. They don't
+    // need a renderer, so headless runs hit the same pixels. Adding the same masks twice gives back the same id,
+    // the mask of frame f is id + f.
+    int AddMask(int clip, int w, int h);
+    const CollisionMask & GetMask(int mask);
+    void Play(Playhead * playhead, int clip);
+    void Rewind(Playhead * playhead);
+    void Advance(Playhead * playheads, int count, double seconds);
+    void RenderClip(RenderSnapshot * snapshot, int clip, Playhead * playhead, int w, int h, double x, double y,
+                    double last_x, double last_y, double angle = 0);
     ~SpriteCache();
 };
 
@@ -21,7 +74,6 @@ class Sprite {
 
     public:
         SDL_Rect d_rect;
-        SDL_Renderer * renderer;
         SDL_RendererFlip flip;
         int x; 
         int y;
@@ -36,7 +88,8 @@ class Sprite {
         void SetDestinationR(SDL_Rect * r);
         virtual void Animate(Clock * clock);
         virtual void Reset();
-        void Render();
+        void Render(RenderSnapshot * snapshot);
+        void Render(RenderSnapshot * snapshot, double last_x, double last_y);
         virtual ~Sprite();
 };
 
@@ -0,0 +1,168 @@
+#pragma once
+
+/*
+    The states of every state machine in the game, and the tables that say which state follows on an event.
+    A transition is a single table lookup: state = player_transitions[state][PLAYER_HIT].
+    The names are only used for hashing the game state and for debugging, never on the per tick path.
+*/
+
+// The game switches between the menu and a level.
+enum GameState {
+    GAME_MENU,
+    GAME_LEVEL,
+    GAME_STATE_COUNT
+};
+
+enum GameEvent {
+    GAME_LEVEL_CHOSEN,
+    GAME_LEVEL_LEFT,
+    GAME_EVENT_COUNT
+};
+
+constexpr const char * game_state_names[GAME_STATE_COUNT] = {"MENU", "GAME"};
+
+constexpr GameState game_transitions[GAME_STATE_COUNT][GAME_EVENT_COUNT] = {
+    //                  LEVEL_CHOSEN  LEVEL_LEFT
+    /* MENU  */        {GAME_LEVEL,   GAME_MENU},
+    /* LEVEL */        {GAME_LEVEL,   GAME_MENU},
+};
+
+
+/*
+    A level counts down, is played until the player runs out of lives or every enemy is dead, and starts over from
+    the countdown when it is played again. The level is still simulated once it is lost or won.
+*/
+enum SceneState {
+    SCENE_STARTING,
+    SCENE_RUNNING,
+    SCENE_LOST,
+    SCENE_WON,
+    SCENE_STATE_COUNT
+};
+
+enum SceneEvent {
+    SCENE_COUNTED_DOWN,
+    SCENE_OUT_OF_LIVES,
+    SCENE_ENEMIES_CLEARED,
+    SCENE_RESET,
+    SCENE_EVENT_COUNT
+};
+
+constexpr const char * scene_state_names[SCENE_STATE_COUNT] = {"STARTING", "RUNNING", "LOST", "WON"};
+
+constexpr SceneState scene_transitions[SCENE_STATE_COUNT][SCENE_EVENT_COUNT] = {
+    //                  COUNTED_DOWN    OUT_OF_LIVES   ENEMIES_CLEARED  RESET
+    /* STARTING */     {SCENE_RUNNING,  SCENE_STARTING, SCENE_STARTING, SCENE_STARTING},
+    /* RUNNING  */     {SCENE_RUNNING,  SCENE_LOST,     SCENE_WON,      SCENE_STARTING},
+    /* LOST     */     {SCENE_LOST,     SCENE_LOST,     SCENE_LOST,     SCENE_STARTING},
+    /* WON      */     {SCENE_WON,      SCENE_LOST,     SCENE_WON,      SCENE_STARTING},
+};
+
+
+// Directions something can move in.
+enum Direction {
+    DIRECTION_NONE,
+    DIRECTION_LEFT,
+    DIRECTION_RIGHT,
+    DIRECTION_UP,
+    DIRECTION_DOWN
+};
+
+
+/*
+    The march of the invaders in a level: sideways until one of them reaches an edge, then down for a moment,
+    then sideways the other way. Going down remembers which side it came from.
+*/
+enum FleetPhase {
+    PHASE_LEFT,
+    PHASE_RIGHT,
+    PHASE_DOWN_FROM_LEFT,
+    PHASE_DOWN_FROM_RIGHT,
+    FLEET_PHASE_COUNT
+};
+
+enum FleetEvent {
+    FLEET_EDGE_REACHED,
+    FLEET_DROPPED,
+    FLEET_EVENT_COUNT
+};
+
+constexpr Direction fleet_directions[FLEET_PHASE_COUNT] = {DIRECTION_LEFT, DIRECTION_RIGHT, DIRECTION_DOWN, DIRECTION_DOWN};
+
+constexpr FleetPhase fleet_transitions[FLEET_PHASE_COUNT][FLEET_EVENT_COUNT] = {
+    //                        EDGE_REACHED           DROPPED
+    /* LEFT            */    {PHASE_DOWN_FROM_LEFT,  PHASE_LEFT},
+    /* RIGHT           */    {PHASE_DOWN_FROM_RIGHT, PHASE_RIGHT},
+    /* DOWN_FROM_LEFT  */    {PHASE_DOWN_FROM_LEFT,  PHASE_RIGHT},
+    /* DOWN_FROM_RIGHT */    {PHASE_DOWN_FROM_RIGHT, PHASE_LEFT},
+};
+
+
+// An enemy that was hit plays its explosion, after which it is out of play (moved after the active enemies) but keeps the state.
+enum EnemyState {
+    ENEMY_DEFAULT,
+    ENEMY_DYING,
+    ENEMY_STATE_COUNT
+};
+
+enum EnemyEvent {
+    ENEMY_HIT,
+    ENEMY_RESET,
+    ENEMY_EVENT_COUNT
+};
+
+constexpr const char * enemy_state_names[ENEMY_STATE_COUNT] = {"DEFAULT", "DYING"};
+
+constexpr EnemyState enemy_transitions[ENEMY_STATE_COUNT][ENEMY_EVENT_COUNT] = {
+    //                  HIT            RESET
+    /* DEFAULT */      {ENEMY_DYING,   ENEMY_DEFAULT},
+    /* DYING   */      {ENEMY_DYING,   ENEMY_DEFAULT},
+};
+
+
+enum PlayerState {
+    PLAYER_DEFAULT,
+    PLAYER_DYING,
+    PLAYER_RESPAWNING,
+    PLAYER_DEAD,
+    PLAYER_STATE_COUNT
+};
+
+enum PlayerEvent {
+    PLAYER_HIT,
+    // the explosion finished, with lives left or without.
+    PLAYER_EXPLODED,
+    PLAYER_OUT_OF_LIVES,
+    PLAYER_RESPAWNED,
+    PLAYER_RESET,
+    PLAYER_EVENT_COUNT
+};
+
+constexpr const char * player_state_names[PLAYER_STATE_COUNT] = {"DEFAULT", "DYING", "RESPAWNING", "DEAD"};
+
+constexpr PlayerState player_transitions[PLAYER_STATE_COUNT][PLAYER_EVENT_COUNT] = {
+    //                  HIT            EXPLODED           OUT_OF_LIVES       RESPAWNED          RESET
+    /* DEFAULT    */   {PLAYER_DYING,  PLAYER_DEFAULT,    PLAYER_DEFAULT,    PLAYER_DEFAULT,    PLAYER_DEFAULT},
+    /* DYING      */   {PLAYER_DYING,  PLAYER_RESPAWNING, PLAYER_DEAD,       PLAYER_DYING,      PLAYER_DEFAULT},
+    /* RESPAWNING */   {PLAYER_DYING,  PLAYER_RESPAWNING, PLAYER_RESPAWNING, PLAYER_DEFAULT,    PLAYER_DEFAULT},
+    /* DEAD       */   {PLAYER_DYING,  PLAYER_DEAD,       PLAYER_DEAD,       PLAYER_DEAD,       PLAYER_DEFAULT},
+};
+
+
+enum ButtonState {
+    BUTTON_DEFAULT,
+    BUTTON_TOUCHED,
+    BUTTON_STATE_COUNT
+};
+
+enum ButtonEvent {
+    BUTTON_ENTER,
+    BUTTON_LEAVE,
+    BUTTON_EVENT_COUNT
+};
+
+constexpr ButtonState button_transitions[BUTTON_STATE_COUNT][BUTTON_EVENT_COUNT] = {
+    //                  ENTER           LEAVE
+    /* DEFAULT */      {BUTTON_TOUCHED, BUTTON_DEFAULT},
+    /* TOUCHED */      {BUTTON_TOUCHED, BUTTON_DEFAULT},
+};
@@ -22,12 +22,17 @@ void TextCache::SetFont(string font, string location){
 }
 
 int TextCache::RenderText(string text, int x, int y, int size, SDL_Color color, int offset){
+    return RenderText(text.c_str(), text.size(), x, y, size, color, offset);
+}
+
+int TextCache::RenderText(const char * text, int length, int x, int y, int size, SDL_Color color, int offset){
     if (current_font == ""){return -1;}
     int d_x = (x - (size/2));
     int d_y = (y - (size/2));
 
     d_rect = {d_x, d_y, size, size};
-    for (auto c: text){
+    for (int i = 0; i < length; i++){
+        char c = text[i];
         if (c == '\n'){
             d_rect.x = d_x;
             d_rect.y += size;
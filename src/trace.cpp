@@ -0,0 +1,178 @@
+#include "trace.h"
+
+Tracer tracer;
+
+Tracer::Tracer(){
+    frequency = (double)SDL_GetPerformanceFrequency();
+}
+
+Tracer::~Tracer(){
+    for (auto buffer: buffers){
+        delete buffer;
+    }
+}
+
+TraceBuffer * Tracer::GetBuffer(){
+    // Each thread finds its buffer the first time it records, after that no lock is taken.
+    static thread_local TraceBuffer * buffer = nullptr;
+    if (!buffer){
+        lock_guard<mutex> guard(lock);
+        buffer = new TraceBuffer();
+        buffer->thread_id = buffers.size() + 1;
+        buffers.push_back(buffer);
+    }
+    return buffer;
+}
+
+TraceEvent * Tracer::NextEvent(){
+    TraceBuffer * buffer = GetBuffer();
+    int current = generation.load(memory_order_acquire);
+    if (buffer->generation.load(memory_order_relaxed) != current){
+        buffer->count.store(0, memory_order_relaxed);
+        // published after the count, so a buffer of the new capture is never read with the count of the last one.
+        buffer->generation.store(current, memory_order_release);
+    }
+    // the events are only allocated once a thread records for the first time.
+    if (buffer->events.empty()){
+        buffer->events.resize(TraceBuffer::CAPACITY);
+    }
+
+    int count = buffer->count.load(memory_order_relaxed);
+    if (count == TraceBuffer::CAPACITY){
+        return nullptr;
+    }
+    return &buffer->events[count];
+}
+
+void Tracer::Start(){
+    // the start time is set before the new capture is published, so a thread that sees the capture sees its start.
+    start_time.store(SDL_GetPerformanceCounter(), memory_order_relaxed);
+    generation.fetch_add(1, memory_order_release);
+    recording = true;
+}
+
+double Tracer::Elapsed(){
+    if (!recording){return 0.0;}
+    return double(SDL_GetPerformanceCounter() - start_time.load(memory_order_relaxed)) / frequency;
+}
+
+void Tracer::SetThreadName(string name){
+    GetBuffer()->thread_name = name;
+}
+
+void Tracer::Zone(const char * name, Uint64 start, Uint64 end){
+    if (!recording.load(memory_order_relaxed) || start < start_time.load(memory_order_relaxed)){return;}
+    TraceEvent * event = NextEvent();
+    if (!event){return;}
+    event->type = TRACE_ZONE;
+    event->name = name;
+    event->start = start;
+    event->end = end;
+    // publishing the new count makes the event visible to the thread that writes the file.
+    GetBuffer()->count.fetch_add(1, memory_order_release);
+}
+
+void Tracer::Instant(const char * name, const char * arg){
+    if (!recording.load(memory_order_relaxed)){return;}
+    TraceEvent * event = NextEvent();
+    if (!event){return;}
+    event->type = TRACE_MARK;
+    event->name = name;
+    event->start = SDL_GetPerformanceCounter();
+    snprintf(event->arg, sizeof(event->arg), "%s", arg);
+    GetBuffer()->count.fetch_add(1, memory_order_release);
+}
+
+void Tracer::Counter(const char * name, double value){
+    if (!recording.load(memory_order_relaxed)){return;}
+    TraceEvent * event = NextEvent();
+    if (!event){return;}
+    event->type = TRACE_VALUE;
+    event->name = name;
+    event->start = SDL_GetPerformanceCounter();
+    event->value = value;
+    GetBuffer()->count.fetch_add(1, memory_order_release);
+}
+
+// names and args are written inside JSON strings, so quotes, backslashes and control characters are escaped.
+static string JsonEscape(const char * text){
+    string escaped;
+    for (; *text; text++){
+        unsigned char c = *text;
+        if (c == '"' || c == '\\'){
+            escaped += '\\';
+            escaped += char(c);
+        }
+        else if (c < 0x20){
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+        }
+        else {
+            escaped += char(c);
+        }
+    }
+    return escaped;
+}
+
+bool Tracer::Stop(string path){
+    if (!recording){return false;}
+    recording = false;
+
+    ofstream file(path.c_str());
+    if (!file.is_open()){
+        return false;
+    }
+
+    // Timestamps are written in microseconds since the capture started.
+    Uint64 start = start_time.load(memory_order_relaxed);
+    auto micros = [this, start](Uint64 time){
+        return double(time - start) * 1000000.0 / frequency;
+    };
+
+    // long enough for an arg where every character had to be escaped.
+    char line[512];
+    bool first = true;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    lock_guard<mutex> guard(lock);
+    int current = generation.load();
+    for (auto buffer: buffers){
+        if (buffer->generation.load(memory_order_acquire) != current){
+            continue;
+        }
+        int count = buffer->count.load(memory_order_acquire);
+        if (count == 0){
+            continue;
+        }
+
+        string thread_name = buffer->thread_name != "" ? buffer->thread_name : "thread " + to_string(buffer->thread_id);
+        snprintf(line, sizeof(line), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",", buffer->thread_id, JsonEscape(thread_name.c_str()).c_str());
+        file << line;
+        first = false;
+
+        for (int i = 0; i < count; i++){
+            TraceEvent &event = buffer->events[i];
+            switch (event.type){
+                case TRACE_ZONE:
+                    snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                            JsonEscape(event.name).c_str(), buffer->thread_id, micros(event.start), micros(event.end) - micros(event.start));
+                    break;
+                case TRACE_MARK:
+                    snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"arg\":\"%s\"}}",
+                            JsonEscape(event.name).c_str(), buffer->thread_id, micros(event.start), JsonEscape(event.arg).c_str());
+                    break;
+                case TRACE_VALUE:
+                    snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"value\":%g}}",
+                            JsonEscape(event.name).c_str(), buffer->thread_id, micros(event.start), event.value);
+                    break;
+            }
+            file << line;
+        }
+    }
+
+    file << "\n]}\n";
+    file.close();
+    return true;
+}
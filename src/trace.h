@@ -0,0 +1,75 @@
+#pragma once
+#include "headers.h"
+
+/*
+    Records a few seconds of the game into a Chrome Trace Event Format file (chrome://tracing or ui.perfetto.dev).
+    The profiler zones show up as nested slices per thread, TRACE_INSTANT marks single events (sounds, deaths, hits,
+    scene changes) and TRACE_COUNTER graphs a value over time.
+
+    Every thread writes into its own buffer, which only that thread ever changes, so recording never takes a lock
+    and never allocates once the buffer exists. The file is written when the capture is stopped.
+    Like the zones, the macros are empty unless SPACE_INVERSION_PROFILING is defined.
+*/
+#ifdef SPACE_INVERSION_PROFILING
+#define TRACE_INSTANT(name, arg) tracer.Instant(name, arg)
+#define TRACE_COUNTER(name, value) tracer.Counter(name, value)
+#else
+#define TRACE_INSTANT(name, arg)
+#define TRACE_COUNTER(name, value)
+#endif
+
+enum TraceEventType {
+    TRACE_ZONE,
+    TRACE_MARK,
+    TRACE_VALUE
+};
+
+struct TraceEvent {
+    TraceEventType type;
+    const char * name;
+    Uint64 start, end;
+    double value;
+    char arg[40];
+};
+
+struct TraceBuffer {
+    static const int CAPACITY = 1 << 17;
+
+    int thread_id = 0;
+    string thread_name = "";
+    // the capture this buffer was last written in, a new capture starts the buffer over. Written by the thread that
+    // owns the buffer and read by the one that stops the capture.
+    atomic<int> generation{-1};
+    atomic<int> count{0};
+    vector<TraceEvent> events;
+};
+
+class Tracer {
+    private:
+        mutex lock;
+        vector<TraceBuffer *> buffers;
+        atomic<int> generation{0};
+        // read by every thread that records, while Start may be setting it on another.
+        atomic<Uint64> start_time{0};
+        double frequency;
+
+        TraceBuffer * GetBuffer();
+        TraceEvent * NextEvent();
+
+    public:
+        atomic<bool> recording{false};
+
+        Tracer();
+        ~Tracer();
+
+        void Start();
+        bool Stop(string path);
+        double Elapsed();
+        void SetThreadName(string name);
+
+        void Zone(const char * name, Uint64 start, Uint64 end);
+        void Instant(const char * name, const char * arg = "");
+        void Counter(const char * name, double value);
+};
+
+extern Tracer tracer;
@@ -0,0 +1,37 @@
+#pragma once
+#include "headers.h"
+
+/*
+    A lock-free triple buffer for handing data from one writer thread to one reader thread.
+    The writer fills Back() and publishes it, the reader always gets the newest published buffer from Front().
+    Neither side ever waits on the other: the writer can publish many times between two reads, and the reader
+    can read the same buffer again if nothing new was published.
+*/
+template <typename T>
+class TripleBuffer {
+    private:
+        static const int NEW_DATA = 4;
+        static const int INDEX = 3;
+
+        T buffers[3];
+        int back = 0;
+        int front = 1;
+        // the buffer in the middle, with NEW_DATA set when the writer published it and the reader didn't take it yet.
+        std::atomic<int> middle{2};
+
+    public:
+        T * Back(){
+            return &buffers[back];
+        }
+
+        void Publish(){
+            back = middle.exchange(back | NEW_DATA) & INDEX;
+        }
+
+        T * Front(){
+            if (middle.load() & NEW_DATA){
+                front = middle.exchange(front) & INDEX;
+            }
+            return &buffers[front];
+        }
+};
\ No newline at end of file
@@ -0,0 +1,102 @@
+/*
+    Projectile field benchmark: keeps a number of projectiles flying on a 1280 by 720 screen at 120 ticks per
+    second, the way the emitters fill the field, and times moving, culling and testing all of them against the
+    player every tick. For comparison it also times moving the same projectiles one object at a time with the trig
+    worked out every tick, the way projectiles used to move.
+
+    Build (from the repository root):
+        g++ -O2 -std=c++17 src/emitter.cpp src/arena.cpp tools/field_bench.cpp -o bin/FieldBench.x86_64 -lSDL2
+
+    Usage:
+        FieldBench.x86_64 [--projectiles N] [--ticks N]
+*/
+#include "../src/headers.h"
+#include "../src/emitter.h"
+
+struct OldProjectile {
+    double x_pos, y_pos;
+    double last_x, last_y;
+    float angle;
+    int speed;
+};
+
+double Seconds(Uint64 start){
+    return double(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+int main(int argc, char ** argv){
+    int projectiles = 50000;
+    int ticks = 1200;
+    for (int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if (arg == "--projectiles" && i + 1 < argc){
+            projectiles = max(1, atoi(argv[++i]));
+        }
+        else if (arg == "--ticks" && i + 1 < argc){
+            ticks = max(1, atoi(argv[++i]));
+        }
+        else {
+            cout << "Usage: " << argv[0] << " [--projectiles N] [--ticks N]" << endl;
+            return 1;
+        }
+    }
+
+    const int width = 1280, height = 720;
+    const double seconds = 1.0 / 120;
+    SDL_Rect player = {620, 600, 36, 36};
+    mt19937 rng(1);
+    ProjectileField field;
+    field.Reserve(projectiles);
+
+    // every tick the field is topped up with volleys from random places, so it stays full as projectiles leave.
+    auto fill = [&](){
+        while (field.count < projectiles){
+            const EmitterPattern &pattern = emitter_patterns[rng() % EMITTER_PATTERN_COUNT];
+            field.Emit(pattern, rng() % width, rng() % height, BinaryAngle(rng()), player.x, player.y);
+        }
+    };
+    fill();
+
+    long live = 0, near = 0;
+    double field_seconds = 0;
+    for (int t = 0; t < ticks; t++){
+        Uint64 start = SDL_GetPerformanceCounter();
+        field.Query(player, [&](int){ near++; });
+        field.Process(seconds, width, height);
+        field_seconds += Seconds(start);
+        live += field.count;
+        fill();
+    }
+
+    // the same number of projectiles, moved the old way.
+    vector<OldProjectile> old(projectiles);
+    for (auto &projectile: old){
+        projectile.x_pos = projectile.last_x = rng() % width;
+        projectile.y_pos = projectile.last_y = rng() % height;
+        projectile.angle = float(rng() % 360) * float(M_PI / 180);
+        projectile.speed = 2 + rng() % 3;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int t = 0; t < ticks; t++){
+        for (auto &projectile: old){
+            projectile.last_x = projectile.x_pos;
+            projectile.last_y = projectile.y_pos;
+            projectile.x_pos += (cos(projectile.angle) * (projectile.speed * 100)) * seconds;
+            projectile.y_pos += (-sin(projectile.angle) * (projectile.speed * 100)) * seconds;
+        }
+    }
+    double old_seconds = Seconds(start);
+    // kept, so the compiler can't drop the loop.
+    volatile double sum = 0;
+    for (auto &projectile: old){
+        sum = sum + projectile.x_pos + projectile.y_pos;
+    }
+
+    double budget = 1000.0 / 120;
+    cout << live / ticks << " projectiles on average over " << ticks << " ticks, " << near << " came close to the player" << endl;
+    cout << "ProjectileField: " << field_seconds * 1000 / ticks << "ms per tick (" << field_seconds * 1000 / ticks / budget * 100
+         << "% of a 120 Hz tick), " << field_seconds * 1e9 / live << "ns per projectile" << endl;
+    cout << "trig every tick, moving only: " << old_seconds * 1000 / ticks << "ms per tick, "
+         << old_seconds * 1e9 / (double(projectiles) * ticks) << "ns per projectile" << endl;
+    return field_seconds * 1000 / ticks < budget ? 0 : 1;
+}
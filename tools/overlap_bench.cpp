@@ -0,0 +1,99 @@
+/*
+    Overlap benchmark: times the batch overlap kernel against one SDL_HasIntersection call per pair, on the same
+    random rects, and checks that both give the same answer for every pair.
+
+    Build (from the repository root):
+        g++ -O2 -std=c++17 src/overlap.cpp src/arena.cpp tools/overlap_bench.cpp -o bin/OverlapBench.x86_64 -lSDL2
+
+    Usage:
+        OverlapBench.x86_64 [--rects N] [--queries N] [--repeat N]
+*/
+#include "../src/headers.h"
+#include "../src/overlap.h"
+
+// a rect of a bullet or an enemy, somewhere on a 1000 by 800 screen.
+SDL_Rect RandomRect(mt19937 &rng){
+    SDL_Rect rect;
+    rect.x = int(rng() % 1000) - 20;
+    rect.y = int(rng() % 800) - 20;
+    rect.w = int(rng() % 40) + 5;
+    rect.h = int(rng() % 40) + 5;
+    return rect;
+}
+
+double Seconds(Uint64 start){
+    return double(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+int main(int argc, char ** argv){
+    int rect_count = 1024;
+    int query_count = 256;
+    int repeat = 200;
+    for (int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if (arg == "--rects" && i + 1 < argc){
+            rect_count = max(1, atoi(argv[++i]));
+        }
+        else if (arg == "--queries" && i + 1 < argc){
+            query_count = max(1, atoi(argv[++i]));
+        }
+        else if (arg == "--repeat" && i + 1 < argc){
+            repeat = max(1, atoi(argv[++i]));
+        }
+        else {
+            cout << "Usage: " << argv[0] << " [--rects N] [--queries N] [--repeat N]" << endl;
+            return 1;
+        }
+    }
+
+    mt19937 rng(1);
+    vector<SDL_Rect> rects(rect_count), queries(query_count);
+    RectBatch batch, query_batch;
+    for (auto &rect: rects){
+        rect = RandomRect(rng);
+        batch.Add(rect);
+    }
+    for (auto &query: queries){
+        query = RandomRect(rng);
+        query_batch.Add(query);
+    }
+    int words = MaskWords(rect_count);
+    vector<Uint32> expected(query_count * words), masks(query_count * words);
+
+    // what is counted is kept, so the compiler can't drop the loops.
+    long sdl_hits = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int r = 0; r < repeat; r++){
+        for (int q = 0; q < query_count; q++){
+            Uint32 * mask = &expected[q * words];
+            memset(mask, 0, words * sizeof(Uint32));
+            for (int i = 0; i < rect_count; i++){
+                if (SDL_HasIntersection(&queries[q], &rects[i])){
+                    mask[i >> 5] |= 1u << (i & 31);
+                    sdl_hits++;
+                }
+            }
+        }
+    }
+    double sdl_seconds = Seconds(start);
+
+    long batch_hits = 0;
+    start = SDL_GetPerformanceCounter();
+    for (int r = 0; r < repeat; r++){
+        OverlapMasks(query_batch, batch, masks.data());
+        for (auto mask: masks){
+            batch_hits += __builtin_popcount(mask);
+        }
+    }
+    double batch_seconds = Seconds(start);
+
+    double pairs = double(rect_count) * query_count * repeat;
+    bool same = masks == expected && sdl_hits == batch_hits;
+    cout << rect_count << " rects against " << query_count << " queries, " << repeat << " times, "
+         << sdl_hits / repeat << " hits each time" << endl;
+    cout << "SDL_HasIntersection: " << sdl_seconds * 1e9 / pairs << "ns per pair" << endl;
+    cout << "OverlapMasks (" << OverlapKernel() << "): " << batch_seconds * 1e9 / pairs << "ns per pair, "
+         << (batch_seconds > 0 ? sdl_seconds / batch_seconds : 0) << "x faster" << endl;
+    cout << (same ? "masks match" : "MASKS DIFFER") << endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+/*
+    Replay farm: re-simulates recorded replays to verify submitted scores.
+
+    Every replay is run in its own Simulation on a pool of worker threads, one per core by default.
+    For each replay the final score, the state hash and the simulation throughput are reported.
+    A replay with results saved next to it (mothership.expected for mothership.rpl) is also checked against them:
+        *|score:900:
+        *|lives:0:
+        *|hash:4cf10cc4c227f491:
+    and a match that ends any other way fails the run.
+
+    Build (from the repository root, with every source file of the game):
+        g++ -O2 -std=c++17 -DSPACE_INVERSION_NO_MAIN $(find src -name '*.cpp') tools/replay_farm.cpp -o bin/ReplayFarm.x86_64 -lSDL2_mixer -lSDL2_ttf -lSDL2 -pthread
+
+    Usage:
+        ReplayFarm.x86_64 [--threads N] replay1.rpl replay2.rpl ...
+*/
+#include "../src/headers.h"
+#include "../src/simulation.h"
+#include "../src/replay.h"
+#include "../src/functions.h"
+#include <thread>
+#include <atomic>
+#include <climits>
+
+struct MatchResult {
+    string path;
+    bool loaded = false;
+    // why the match couldn't be played, when it wasn't loaded.
+    string error = "";
+    int score = 0;
+    int lives = 0;
+    Uint64 hash = 0;
+    long ticks = 0;
+    double seconds = 0.0;
+    // the results saved next to the replay, if there are any, and whether the match ended with them.
+    bool checked = false;
+    bool expected = true;
+    int expected_score = 0;
+    int expected_lives = 0;
+    Uint64 expected_hash = 0;
+};
+
+// reads the results saved next to the replay, false if there are none or they can't be read.
+bool LoadExpected(MatchResult * result){
+    ifstream file(filesystem::path(result->path).replace_extension(".expected").string().c_str());
+    if (!file.is_open()){
+        return false;
+    }
+    bool score = false, lives = false, hash = false;
+    string line;
+    while (getline(file, line)){
+        vector<string> section = split(line, '|');
+        vector<string> subsect = section.size() < 2 ? vector<string>() : split(section[1], ':');
+        if (section.empty() || section[0] != "*" || subsect.size() < 2){
+            continue;
+        }
+        long long value;
+        if (subsect[0] == "score" && ParseInteger(subsect[1], INT_MIN, INT_MAX, &value)){
+            result->expected_score = int(value);
+            score = true;
+        }
+        else if (subsect[0] == "lives" && ParseInteger(subsect[1], INT_MIN, INT_MAX, &value)){
+            result->expected_lives = int(value);
+            lives = true;
+        }
+        else if (subsect[0] == "hash" && !subsect[1].empty()){
+            char * end = nullptr;
+            result->expected_hash = strtoull(subsect[1].c_str(), &end, 16);
+            hash = *end == '\0';
+        }
+    }
+    return score && lives && hash;
+}
+
+void RunMatch(MatchResult * result){
+    Replay replay;
+    if (!replay.Load(result->path)){
+        result->error = "couldn't load replay";
+        return;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    Simulation simulation(replay.level_path, replay.tick_rate, replay.seed);
+    if (!simulation.Loaded()){
+        result->error = "couldn't load level " + replay.level_path;
+        return;
+    }
+    result->loaded = true;
+    for (size_t tick = 0; tick < replay.inputs.size(); tick++){
+        PlayerInput input = replay.GetInput(tick);
+        simulation.Tick(&input);
+    }
+    result->seconds = double(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+    result->score = simulation.Score();
+    result->lives = simulation.Lives();
+    result->hash = simulation.StateHash();
+    result->ticks = simulation.ticks;
+
+    if (LoadExpected(result)){
+        result->checked = true;
+        result->expected = result->score == result->expected_score && result->lives == result->expected_lives
+                           && result->hash == result->expected_hash;
+    }
+}
+
+int main(int argc, char ** argv){
+    int threads = thread::hardware_concurrency();
+    vector<MatchResult> results;
+
+    for (int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc){
+            threads = atoi(argv[++i]);
+        }
+        else {
+            MatchResult result;
+            result.path = arg;
+            results.push_back(result);
+        }
+    }
+    if (results.empty()){
+        cout << "Usage: " << argv[0] << " [--threads N] replay1.rpl replay2.rpl ..." << endl;
+        return 1;
+    }
+    threads = max(1, min(threads, int(results.size())));
+
+    // the workers take the next match that nobody is running yet until there are none left.
+    atomic<size_t> next_match(0);
+    Uint64 start = SDL_GetPerformanceCounter();
+    vector<thread> workers;
+    for (int i = 0; i < threads; i++){
+        workers.push_back(thread([&](){
+            size_t match;
+            while ((match = next_match.fetch_add(1)) < results.size()){
+                RunMatch(&results[match]);
+            }
+        }));
+    }
+    for (auto &worker: workers){
+        worker.join();
+    }
+    double seconds = double(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+    int failed = 0, mismatched = 0;
+    long total_ticks = 0;
+    for (auto &result: results){
+        if (!result.loaded){
+            cout << result.path << ": " << result.error << endl;
+            failed++;
+            continue;
+        }
+        total_ticks += result.ticks;
+        cout << result.path << ": score " << result.score << ", lives " << result.lives
+             << ", hash " << hex << result.hash << dec << ", " << result.ticks << " ticks in "
+             << result.seconds * 1000 << "ms (" << (result.seconds > 0 ? result.ticks / result.seconds : 0) << " ticks/s)" << endl;
+        if (result.checked && result.expected){
+            cout << result.path << ": ended with its saved results" << endl;
+        }
+        else if (result.checked){
+            cout << result.path << ": expected score " << result.expected_score << ", lives " << result.expected_lives
+                 << ", hash " << hex << result.expected_hash << dec << ", FAILED" << endl;
+            mismatched++;
+        }
+    }
+
+    cout << results.size() - failed << " matches on " << threads << " threads in " << seconds << "s ("
+         << (seconds > 0 ? (results.size() - failed) / seconds : 0) << " matches/s, "
+         << (seconds > 0 ? total_ticks / seconds : 0) << " ticks/s)" << endl;
+    if (mismatched){
+        cout << mismatched << " matches didn't end the way their saved results say" << endl;
+    }
+    return failed || mismatched ? 1 : 0;
+}